@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""
+Doorbell - eventfd-Wecker der C++ Treiber (GPIO und Touch UI)
+
+Der Treiber lauscht auf einem Unix-Socket und gibt jedem Leser ein eigenes
+eventfd (SCM_RIGHTS). Das eventfd wird lesbar sobald neue Events im Ring
+liegen; der Socket wird lesbar (EOF) wenn der Treiber beendet wird.
+"""
+
+import os
+import select
+import socket
+import time
+
+POLL_S = 0.001      # ohne Doorbell: Ring weiter im Millisekunden-Takt pollen
+RETRY_S = 1.0       # Abstand zwischen Verbindungsversuchen nach Treiber-Neustart
+
+
+class Doorbell:
+    def __init__(self, path, name, on_reconnect=None, active=None):
+        self.path = path
+        self.name = name
+        # on_reconnect: nach automatischem Neuverbinden (Treiber neu gestartet)
+        # den Ring neu abbilden. active: Ring abgebildet? Nur dann wird ohne
+        # Doorbell im POLL_S-Takt gepollt
+        self.on_reconnect = on_reconnect
+        self.active = active
+        self.efd = None
+        self.sock = None
+        self.retry_at = 0.0
+        self.warned = False
+
+    def connect(self):
+        """Eigenes eventfd vom Treiber holen"""
+        self.retry_at = time.monotonic() + RETRY_S
+        try:
+            sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+            try:
+                sock.connect(self.path)
+                _, fds, _, _ = socket.recv_fds(sock, 1, 1)
+            except Exception:
+                sock.close()
+                raise
+            if not fds:
+                sock.close()
+                raise RuntimeError("no eventfd received")
+            os.set_blocking(fds[0], False)
+            self.efd = fds[0]
+            self.sock = sock
+            self.warned = False
+            print(f"🔔 {self.name} doorbell connected")
+            return True
+        except Exception as e:
+            # Nur einmal melden, sonst alle RETRY_S eine Zeile
+            if not self.warned:
+                print(f"⚠️  {self.name} doorbell not available ({e}) - polling")
+                self.warned = True
+            return False
+
+    def close(self):
+        if self.efd is not None:
+            os.close(self.efd)
+            self.efd = None
+        if self.sock:
+            self.sock.close()
+            self.sock = None
+
+    @property
+    def connected(self):
+        return self.efd is not None
+
+    def fileno(self):
+        """Für eigene select/epoll-Loops (-1 = keine Doorbell)"""
+        return self.efd if self.efd is not None else -1
+
+    def reconnect(self):
+        """Nach Treiber-Neustart: höchstens alle RETRY_S neu verbinden"""
+        if self.efd is None and time.monotonic() >= self.retry_at:
+            if self.connect() and self.on_reconnect:
+                self.on_reconnect()
+        return self.efd is not None
+
+    def handle(self, readable):
+        """Nach select: EOF auf dem Socket abbauen, eventfd zurücksetzen"""
+        if self.efd is None:
+            return
+        if self.sock in readable:
+            # Treiber beendet - zurück zum Pollen, später neu verbinden
+            print(f"⚠️  {self.name} doorbell closed by driver")
+            self.close()
+            self.retry_at = time.monotonic() + RETRY_S
+            return
+        if self.efd in readable:
+            # Zurücksetzen vor dem Lesen des Rings: was danach kommt, klingelt erneut
+            try:
+                os.read(self.efd, 8)
+            except BlockingIOError:
+                pass
+
+
+def wait(doorbells, timeout):
+    """Ein select über alle Doorbells. Fehlt eine, wird im POLL_S-Takt gepollt
+    (nur solange der Ring dazu abgebildet ist)."""
+    fds = []
+    for bell in doorbells:
+        if bell.reconnect():
+            fds += [bell.efd, bell.sock]
+        elif bell.active is None or bell.active():
+            timeout = min(timeout, POLL_S)
+    if not fds:
+        time.sleep(timeout)
+        return
+    readable, _, _ = select.select(fds, [], [], timeout)
+    for bell in doorbells:
+        bell.handle(readable)
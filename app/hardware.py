@@ -9,6 +9,7 @@ from luma.oled.device import sh1106
 import smbus2 as smbus
 import configparser
 from display import Layout
+import doorbell
 
 class Hardware:
     def __init__(self):
@@ -127,10 +128,21 @@ class Hardware:
         for display in self.displays.values():
             display.draw()
     
+    def wait(self, timeout, doorbells=()):
+        """Schläft bis ein Treiber neue Events meldet (oder timeout Sekunden).
+
+        doorbells: weitere Doorbells (z.B. C++ UI), alle in einem select
+        """
+        bells = list(doorbells)
+        if self.bridge:
+            bells.append(self.bridge.doorbell)
+        doorbell.wait(bells, timeout)
+
     def close(self):
         """Schließt alle Hardware-Komponenten"""
-        if self.bridge and self.bridge.mmap:
-            self.bridge.mmap.close()
+        if self.bridge:
+            self.bridge.close_doorbell()
+            self.bridge.close_shared_memory()
 
         for display in self.displays.values():
             try:
@@ -154,72 +166,182 @@ class Hardware:
             self.displays[display_id].overlay(output)
 
 class GPIOBridge:
+    """Liest den Event-Ring /tauwerk_gpio des C++ Treibers (Layout v2).
+
+    Header: magic, version, capacity, slot_size, epoch (je uint32), seq @64,
+    dropped @72, read_seq @128. Slots ab 192, je 32 Bytes:
+    seq (uint64), timestamp_ns (int64), type, pin, value, reserved (int32).
+    Event n liegt in Slot (n - 1) % capacity.
+    """
+    MAGIC = 0x54415557
+    VERSION = 2
+    HEADER_SIZE = 192
+    SLOT = struct.Struct('<QqiiiI')
+    # Event-Typen des Treibers (EventType in tauwerk_gpio_driver.cpp)
+    EVENT_TYPES = {
+        0: 'encoder',
+        1: 'button',        # roh: value 1 = gedrückt, 0 = losgelassen
+        2: 'tap',
+        3: 'double_tap',
+        4: 'long_press',
+        5: 'repeat',        # value = Nummer der Wiederholung
+    }
+
+    DOORBELL_PATH = "/tmp/tauwerk_gpio_doorbell"
+
     def __init__(self, shm_path="/tauwerk_gpio"):
         self.shm_path = f"/dev/shm{shm_path}"
-        self.buffer_size = 256
-        self.last_read_index = 0
-        self.setup_shared_memory()
+        self.capacity = 0
+        self.last_seq = 0
+        self.lost = 0           # vom Treiber überholt, bevor wir lesen konnten
+        self.epoch = 0          # Treiberstart, zu dem last_seq gehört
+        self.mmap = None
+        self.shm_fd = None
+        self.remap_at = 0.0     # nächste Prüfung, ob das Segment noch aktuell ist
+        self.warned = False
+        # Nach Treiber-Neustart neu verbinden und das neue Segment abbilden
+        self.doorbell = doorbell.Doorbell(self.DOORBELL_PATH, "GPIO",
+                                          on_reconnect=self.setup_shared_memory,
+                                          active=lambda: self.mmap is not None)
+        self.setup_shared_memory(skip_old=True)
+        self.connect_doorbell()
         
-    def setup_shared_memory(self):
+    def setup_shared_memory(self, skip_old=False):
+        """(Neu) abbilden - stop() des Treibers entfernt das Segment, ein
+        neu gestarteter Treiber legt ein neues an.
+
+        skip_old: nur beim Start der App - alte Events nicht nachspielen
+        """
+        self.close_shared_memory()
+        self.remap_at = time.monotonic() + doorbell.RETRY_S
         try:
-            # Shared Memory öffnen
+            # Shared Memory öffnen - Größe aus dem Segment, nicht fest verdrahtet
             self.shm_fd = os.open(self.shm_path, os.O_RDWR)
-            # Puffer: 256 Events * 16 Bytes + 16 Bytes für Metadaten
-            self.mmap = mmap.mmap(self.shm_fd, 256 * 16 + 16, mmap.MAP_SHARED, mmap.PROT_READ | mmap.PROT_WRITE)
-            
+            size = os.fstat(self.shm_fd).st_size
+            self.mmap = mmap.mmap(self.shm_fd, size, mmap.MAP_SHARED, mmap.PROT_READ | mmap.PROT_WRITE)
+
+            magic, version, capacity, slot_size = struct.unpack_from('<IIII', self.mmap, 0)
+            if magic != self.MAGIC or version != self.VERSION or slot_size != self.SLOT.size \
+                    or size < self.HEADER_SIZE + capacity * slot_size:
+                if not self.warned:
+                    print(f"❌ GPIO shared memory layout mismatch (magic {magic:#x}, version {version}) - driver too old?")
+                    self.warned = True
+                self.close_shared_memory()
+                return
+
+            self.capacity = capacity
+            epoch = struct.unpack_from('<I', self.mmap, 16)[0]
+            if epoch != self.epoch:
+                # Neuer Treiberstart: alles im Ring ist neu. Gleiche Epoche
+                # (doppelt abgebildet): last_seq gilt weiter
+                self.last_seq = self.get_sequence() if skip_old else 0
+                self.epoch = epoch
+            self.warned = False
             print("✅ Connected to GPIO shared memory")
                 
         except Exception as e:
-            print(f"❌ Failed to connect to shared memory: {e}")
+            # Nur einmal melden - ohne Treiber wird alle RETRY_S neu versucht
+            if not self.warned:
+                print(f"❌ Failed to connect to shared memory: {e}")
+                self.warned = True
+            self.close_shared_memory()
+
+    def close_shared_memory(self):
+        if self.mmap:
+            self.mmap.close()
             self.mmap = None
+        if self.shm_fd is not None:
+            os.close(self.shm_fd)
+            self.shm_fd = None
+
+    def check_shared_memory(self):
+        """Höchstens alle RETRY_S: fehlt das Segment oder wurde es entfernt
+        (Treiber beendet), neu abbilden"""
+        if time.monotonic() < self.remap_at:
+            return
+        if self.mmap is None or os.fstat(self.shm_fd).st_nlink == 0:
+            self.setup_shared_memory()
+        else:
+            self.remap_at = time.monotonic() + doorbell.RETRY_S
     
-    def get_write_index(self):
-        """Liest den aktuellen Write Index vom C++ Treiber"""
+    def connect_doorbell(self):
+        """Eigenes eventfd vom Treiber holen - wird lesbar sobald neue Events im Ring liegen"""
+        return self.doorbell.connect()
+
+    def close_doorbell(self):
+        self.doorbell.close()
+
+    def fileno(self):
+        """Für eigene select/epoll-Loops (-1 = keine Doorbell)"""
+        return self.doorbell.fileno()
+
+    def wait(self, timeout):
+        """Blockiert bis zur Doorbell oder timeout. Ohne Doorbell: 1 ms pollen."""
+        doorbell.wait([self.doorbell], timeout)
+
+    def get_sequence(self):
+        """Sequenz des zuletzt veröffentlichten Events"""
         if not self.mmap:
             return 0
-            
-        try:
-            # Write Index ist am Ende des Event-Buffers
-            offset = 256 * 16  # 256 Events * 16 Bytes
-            write_index_data = self.mmap[offset:offset + 4]
-            return struct.unpack('I', write_index_data)[0]  # unsigned int
-        except Exception as e:
-            print(f"Error reading write index: {e}")
+        return struct.unpack_from('<Q', self.mmap, 64)[0]
+
+    def get_dropped(self):
+        """Vom Treiber gezählte, ungelesen überschriebene Events"""
+        if not self.mmap:
             return 0
+        return struct.unpack_from('<Q', self.mmap, 72)[0]
     
     def read_events(self):
+        self.check_shared_memory()
         if not self.mmap:
             return []
             
         events = []
         try:
-            current_write_index = self.get_write_index()
-            #print(f"Read index: {self.last_read_index}, Write index: {current_write_index}")
-            
-            # Nur neue Events lesen (Ringpuffer)
-            while self.last_read_index != current_write_index:
-                offset = self.last_read_index * 16  # 4 ints * 4 bytes
-                event_data = self.mmap[offset:offset + 16]
-                
-                if len(event_data) == 16:
-                    # Event-Struktur: type, pin, value, timestamp (je 4 Bytes)
-                    event_type, pin, value, timestamp = struct.unpack('iiii', event_data)
-                    
-                    #print(f"Raw event - type:{event_type}, pin:{pin}, value:{value}, timestamp:{timestamp}")
-                    
-                    # Event validieren
-                    if event_type in [0, 1] and pin >= 0:
-                        event = {
-                            'type': 'encoder' if event_type == 0 else 'button',
-                            'pin': pin,
-                            'value': value,
-                            'timestamp': timestamp
-                        }
-                        events.append(event)
-                        #print(f"✅ Valid event: {event}")
-                
-                # Nächsten Index (Ringpuffer)
-                self.last_read_index = (self.last_read_index + 1) % 256
+            magic, epoch = struct.unpack_from('<I12xI', self.mmap, 0)
+            if magic != self.MAGIC:
+                # Treiber initialisiert den Ring gerade neu - beim nächsten
+                # Lesen neu abbilden und den Header neu prüfen
+                self.remap_at = min(self.remap_at, time.monotonic())
+                return []
+            seq = self.get_sequence()
+
+            # Treiber neu gestartet (z.B. nach SIGKILL, ohne shm_unlink):
+            # seq zählt wieder ab 0 - alles im Ring ist neu
+            if epoch != self.epoch or seq < self.last_seq:
+                print(f"⚠️  GPIO driver restarted - resync at seq {seq}")
+                self.epoch = epoch
+                self.last_seq = 0
+
+            # Überholt: auf die ältesten noch vorhandenen Events aufsetzen
+            if seq - self.last_seq > self.capacity:
+                self.lost += seq - self.last_seq - self.capacity
+                self.last_seq = seq - self.capacity
+
+            while self.last_seq < seq:
+                n = self.last_seq + 1
+                offset = self.HEADER_SIZE + ((n - 1) % self.capacity) * self.SLOT.size
+                slot_seq, timestamp, event_type, pin, value, _ = self.SLOT.unpack_from(self.mmap, offset)
+                # Slot während des Lesens überschrieben -> neu aufsetzen
+                if slot_seq != n or struct.unpack_from('<Q', self.mmap, offset)[0] != n:
+                    seq = self.get_sequence()
+                    resume = max(n, seq - self.capacity)
+                    self.lost += resume - n + 1
+                    self.last_seq = resume
+                    continue
+                self.last_seq = n
+
+                # Event validieren
+                if event_type in self.EVENT_TYPES and pin >= 0:
+                    events.append({
+                        'type': self.EVENT_TYPES[event_type],
+                        'pin': pin,
+                        'value': value,
+                        'timestamp': timestamp      # ns, CLOCK_MONOTONIC
+                    })
+
+            # Lesestand zurückmelden (nur für die dropped-Statistik des Treibers)
+            struct.pack_into('<Q', self.mmap, 128, self.last_seq)
                         
         except Exception as e:
             print(f"Error reading events: {e}")
@@ -228,12 +350,13 @@ class GPIOBridge:
 
 class Event:
     """Vereinfachte Event-Klasse - kompatibel mit deiner main.py"""
-    def __init__(self, id=None, pin=None, name=None, type=None, value=None, direction=None, state=None, tick=None):
+    def __init__(self, id=None, pin=None, name=None, type=None, value=None, direction=None, state=None, tick=None, delta=None):
         self.id = id
         self.pin = pin
         self.name = name
         self.type = type
         self.direction = direction
+        self.delta = delta if delta is not None else direction  # Encoder: beschleunigte Schritte
         self.value = value
         self.state = state
         self.tick = tick
@@ -243,6 +366,11 @@ class Event:
         self.RIGHT = (direction == 1) if direction is not None else None
         self.PRESS = (state == "PRESSED") if state else None
         self.RELEASE = (state == "RELEASED") if state else None
+        # Gesten vom Treiber (type "button", state = Geste)
+        self.TAP = state == "TAP"
+        self.DOUBLE_TAP = state == "DOUBLE_TAP"
+        self.LONG_PRESS = state == "LONG_PRESS"
+        self.REPEAT = state == "REPEAT"
 
     def parent(self, name):
         return self.name == name
@@ -301,8 +429,8 @@ class Controller:
     def close(cls):
         """Schließt alle Controller"""
         for controller in cls.controllers.values():
-            if hasattr(controller, 'bridge') and controller.bridge.mmap:
-                controller.bridge.mmap.close()
+            if hasattr(controller, 'bridge'):
+                controller.bridge.close_shared_memory()
         cls.controllers.clear()
 
 class Encoder(Controller):
@@ -315,9 +443,10 @@ class Encoder(Controller):
     def process_events(self, events):
         for event_data in events:
             if event_data['type'] == 'encoder' and event_data['pin'] in self.pins:
-                # C++ Treiber liefert bereits die direction
-                direction = event_data['value']
-                self.value += direction
+                # C++ Treiber liefert Rasten inkl. Beschleunigung (z.B. +5)
+                delta = event_data['value']
+                direction = 1 if delta > 0 else -1
+                self.value += delta
                 
                 # Event für Listener erstellen
                 event = Event(
@@ -326,6 +455,7 @@ class Encoder(Controller):
                     name=self.pin_to_name.get(event_data['pin']),
                     type="encoder",
                     direction=direction,
+                    delta=delta,
                     value=self.value,
                     tick=event_data['timestamp']
                 )
@@ -339,6 +469,8 @@ class Encoder(Controller):
         Encoder.controllers[id] = Encoder(id, bridge, pins, listeners)
 
 class Button(Controller):
+    GESTURES = {'tap': "TAP", 'double_tap': "DOUBLE_TAP", 'long_press': "LONG_PRESS", 'repeat': "REPEAT"}
+
     def __init__(self, id, bridge, pins, listeners=None):
         super().__init__(id, bridge, listeners)
         self.pins = pins  # {"push": 16, "back": 20, "confirm": 21}
@@ -353,8 +485,23 @@ class Button(Controller):
         for event_data in events:
             #print(f"🔘 Processing event: pin={event_data['pin']}, value={event_data['value']}")
             
+            # Gesten: kein Zustand, direkt weiterreichen
+            if event_data['type'] in self.GESTURES and event_data['pin'] in self.pins.values():
+                pin = event_data['pin']
+                event = Event(
+                    id=self.id,
+                    pin=pin,
+                    name=self.pin_to_name.get(pin, "unknown"),
+                    type="button",
+                    state=self.GESTURES[event_data['type']],
+                    value=event_data['value'],
+                    tick=event_data['timestamp']
+                )
+                self.last_events.append(event)
+                self.notify_listeners(event)
+
             # Prüfe ob dieser Pin zu unseren Buttons gehört
-            if event_data['type'] == 'button' and event_data['pin'] in self.pins.values():
+            elif event_data['type'] == 'button' and event_data['pin'] in self.pins.values():
                 pin = event_data['pin']
                 button_name = self.pin_to_name.get(pin, "unknown")
                 new_state = "PRESSED" if event_data['value'] == 1 else "RELEASED"
@@ -31,10 +31,14 @@ class Tauwerk:
 
     def setup_cpp_ui(self):
         """Setup C++ UI mit Tauwerk Elementen"""
+        # Startet der Treiber (neu), legt die Bridge die Elemente erneut an
+        self.ui_bridge.on_reconnect = self.create_cpp_ui
         if not self.ui_bridge.connect():
             print("⚠️  C++ UI nicht verfügbar - fallback zu OLEDs")
             return
-            
+        self.create_cpp_ui()
+
+    def create_cpp_ui(self):
         # Erstelle Haupt-UI in C++
         self.ui_bridge.create_button(1, 0, 0, 195, 120, "PLAY", 0xCCEEEC)
         self.ui_bridge.create_button(2, 205, 0, 195, 120, "STOP", 0xCCEEEC)
@@ -147,11 +151,11 @@ class Tauwerk:
     def onencoder(self, event=None):
         if event.ENCODER:
             if self.label == "MAIN":
-                self.main_value += event.direction
+                self.main_value += event.delta
             elif self.label == "TRACK":
-                self.track_value += event.direction
+                self.track_value += event.delta
             elif self.label == "CREATURE":
-                self.creature_value += event.direction * 10
+                self.creature_value += event.delta * 10
     
     def dispatch(self, event=None):
         if event:
@@ -171,11 +175,14 @@ class Tauwerk:
 
     def run(self):
         print(f"🚀 Starting {self.name}")
+        # GPIO und C++ UI wecken per Doorbell (ein select); ohne Doorbell wird 1 ms gepollt,
+        # ohne Treiber nur alle RETRY_S neu verbunden
+        doorbells = [self.ui_bridge.doorbell]
         try:
             while self.running:
                 self.hardware.run()
                 self.handle_ui_events()  # NEU: C++ UI Events verarbeiten
-                time.sleep(0.001)  # 100 FPS
+                self.hardware.wait(0.05, doorbells)
                         
         except KeyboardInterrupt:
             self.close()
@@ -1,23 +1,197 @@
 import zmq
+import ctypes
 import json
+import os
+import re
+import struct
 import threading
+import time
 import logging
+from contextlib import contextmanager
 from typing import Callable, Optional
 
 logger = logging.getLogger(__name__)
 
+# Binary IPC records - layouts mirror src/midi/ipc_protocol.hpp (little-endian).
+# Each record: header <BBH (version, command, size incl. header) + body.
+IPC_VERSION = 1
+_RECORDS = {
+    "cc":           (0,  "BBBx",     ("channel", "controller", "value")),
+    "note":         (1,  "BBBx",     ("channel", "note", "velocity")),
+    "bpm":          (2,  "4xd",      ("bpm",)),
+    "bpm_ramp":     (3,  "id",       ("ticks", "bpm")),
+    "clock_mode":   (4,  "B3x",      ("mode",)),
+    "clock_start":  (5,  "",         ()),
+    "clock_stop":   (6,  "",         ()),
+    "param":        (7,  "B3xf",     ("param", "value")),
+    "learn":        (8,  "BBBB",     ("param", "min", "max", "pickup")),
+    "learn_cancel": (9,  "",         ()),
+    "mpe_config":   (10, "BB2x",     ("channels", "bend_range")),
+    "mpe_on":       (11, "BBBxff",   ("voice", "note", "velocity", "bend", "timbre")),
+    "mpe_expr":     (12, "B3xfff",   ("voice", "bend", "pressure", "timbre")),
+    "mpe_off":      (13, "BB2x",     ("voice", "velocity")),
+    "cc14":         (14, "BBH",      ("channel", "controller", "value")),
+    "nrpn":         (15, "BBHH2x",   ("channel", "hires", "parameter", "value")),
+    "rpn":          (16, "BBHH2x",   ("channel", "hires", "parameter", "value")),
+    "lfo":          (20, "BBBBBB2xffff", ("index", "shape", "target", "channel", "controller", "tempo_sync",
+                                          "rate", "depth", "center", "phase_offset")),
+    "lfo_clear":    (21, "B3x",      ("index",)),
+    "automation_lane":  (22, "BBBx", ("lane", "channel", "controller")),
+    "automation_clear": (23, "B3x",  ("lane",)),
+    "automation_arm":   (25, "BB2x", ("lane", "armed")),
+    "automation_write": (26, "B3xf", ("lane", "value")),
+    "loop_length":      (27, "i",    ("ticks",)),
+}
+_CMD_MORPH_TARGETS = 17
+_CMD_MORPH_SNAPSHOT = 18
+_CMD_STATS = 19
+_CMD_AUTOMATION_POINTS = 24
+CLOCK_PPQN = 24
+AUTOMATION_SUBTICKS = 16        # per clock tick (AutomationEngine::SUBTICKS)
+_DEFAULTS = {"min": 0, "max": 255, "pickup": 1, "hires": 1,
+             "controller": 1, "rate": 1.0, "depth": 1.0, "center": 0.5}
+# LfoShape / ModTarget in src/midi/modulation.hpp
+LFO_SHAPES = ("sine", "triangle", "saw", "square", "sample_hold", "random_walk")
+LFO_TARGETS = (None, "cc", "pitch_bend")
+
+
+def encode_record(message: dict) -> Optional[bytes]:
+    """Encode a command dict as binary record, None if there is no binary form"""
+    mtype = message.get("type")
+    if mtype == "morph_targets":
+        targets = message["targets"]
+        body = struct.pack("<H2x", len(targets)) + b"".join(
+            struct.pack("<BBBx", ch & 0x0F, cc & 0x7F, 1 if hires else 0) for ch, cc, hires in targets)
+        command = _CMD_MORPH_TARGETS
+    elif mtype == "morph_snapshot":
+        values = message["values"]
+        body = struct.pack("<BxH", message["slot"], len(values)) + struct.pack(f"<{len(values)}f", *values)
+        command = _CMD_MORPH_SNAPSHOT
+    elif mtype == "automation_points":
+        points = message["points"]
+        body = struct.pack("<BxH", message["lane"], len(points)) + b"".join(
+            struct.pack("<IH2x", subtick, value & 0x3FFF) for subtick, value in points)
+        command = _CMD_AUTOMATION_POINTS
+    elif mtype in _RECORDS:
+        command, fmt, fields = _RECORDS[mtype]
+        values = []
+        for field, code in zip(fields, re.sub(r"\d*x", "", fmt)):
+            value = message.get(field, _DEFAULTS.get(field, 0))
+            values.append(int(value) & (0xFF if code == "B" else 0xFFFF) if code in "BH" else value)
+        body = struct.pack("<" + fmt, *values)
+    else:
+        return None
+    return struct.pack("<BBH", IPC_VERSION, command, 4 + len(body)) + body
+
+
+class CommandRing:
+    """Shared-memory command ring /tauwerk_midi_commands (src/midi/command_ring.hpp)
+
+    Hot path for fader -> CC without a socket round trip. Uses the C-ABI
+    producer bin/libtauwerk_midi_commands.so (make commands-lib). Single
+    producer: only call from one thread.
+    """
+    LIB_PATH = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "bin",
+                            "libtauwerk_midi_commands.so")
+
+    def __init__(self, name: str = "/tauwerk_midi_commands", lib_path: Optional[str] = None):
+        self.lib = ctypes.CDLL(lib_path or self.LIB_PATH)
+        self.lib.tauwerk_commands_open.restype = ctypes.c_void_p
+        self.lib.tauwerk_commands_open.argtypes = [ctypes.c_char_p]
+        self.lib.tauwerk_commands_close.argtypes = [ctypes.c_void_p]
+        self.lib.tauwerk_commands_dropped.restype = ctypes.c_uint
+        self.lib.tauwerk_commands_dropped.argtypes = [ctypes.c_void_p]
+        for fn in ("cc", "note", "cc14"):
+            getattr(self.lib, f"tauwerk_commands_{fn}").argtypes = [ctypes.c_void_p] + [ctypes.c_int] * 3
+        for fn in ("nrpn", "rpn"):
+            getattr(self.lib, f"tauwerk_commands_{fn}").argtypes = [ctypes.c_void_p] + [ctypes.c_int] * 4
+        self.lib.tauwerk_commands_param.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_float]
+        self.lib.tauwerk_commands_automation.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_float]
+
+        self.handle = self.lib.tauwerk_commands_open(name.encode())
+        if not self.handle:
+            raise OSError(f"command ring {name} not available (engine not running?)")
+        self.closed = False
+
+    def close(self):
+        if self.handle:
+            self.lib.tauwerk_commands_close(self.handle)
+            self.handle = None
+
+    def _sent(self, result: int) -> bool:
+        if result == -2:
+            # Engine closed the segment (restart) - this mapping is orphaned
+            self.closed = True
+        return result == 0
+
+    # All senders return False when the ring is full or closed (see .closed)
+    def cc(self, channel: int, controller: int, value: int) -> bool:
+        return self._sent(self.lib.tauwerk_commands_cc(self.handle, channel, controller, value))
+
+    def note(self, channel: int, note: int, velocity: int) -> bool:
+        return self._sent(self.lib.tauwerk_commands_note(self.handle, channel, note, velocity))
+
+    def cc14(self, channel: int, controller: int, value: int) -> bool:
+        return self._sent(self.lib.tauwerk_commands_cc14(self.handle, channel, controller, value))
+
+    def nrpn(self, channel: int, parameter: int, value: int, hires: bool = True, rpn: bool = False) -> bool:
+        fn = self.lib.tauwerk_commands_rpn if rpn else self.lib.tauwerk_commands_nrpn
+        return self._sent(fn(self.handle, channel, parameter, value, int(hires)))
+
+    def param(self, param: int, value: float) -> bool:
+        return self._sent(self.lib.tauwerk_commands_param(self.handle, param, value))
+
+    def automation(self, lane: int, value: float) -> bool:
+        return self._sent(self.lib.tauwerk_commands_automation(self.handle, lane, value))
+
+    @property
+    def dropped(self) -> int:
+        return self.lib.tauwerk_commands_dropped(self.handle)
+
+
 class MidiBridge:
-    def __init__(self):
+    RING_TYPES = ("cc", "note", "cc14", "nrpn", "rpn", "param", "automation_write")
+    RING_FALLBACK_S = 0.05      # after the ring was full: stay on ZMQ until the burst pauses this long
+    RING_RETRY_S = 1.0          # reopen interval after the engine closed the ring
+
+    def __init__(self, use_json: bool = False, client_name: Optional[str] = None):
+        """use_json: send readable JSON instead of binary records (debugging)
+        client_name: session name shown in the engine's per-client statistics"""
+        self.use_json = use_json
+        self.client_name = client_name
         self.context = zmq.Context()
         self.socket = None
         self.receiver_thread = None
         self.running = False
         self.callbacks = []
+        self._batch = None
+        self.ring = None
+        self.ring_name = None
+        self._ring_retry_at = 0.0
+        self._ring_full_until = 0.0
+        self.state = {}
+        self.params = []        # last engine parameter values (telemetry "params")
+        
+    def attach_ring(self, name: str = "/tauwerk_midi_commands") -> bool:
+        """Send CC/note/CC14/(N)RPN/param through the shared-memory ring (falls back to ZMQ when full)"""
+        self.ring_name = name
+        try:
+            self.ring = CommandRing(name)
+            logger.info("⚡ Using shared-memory command ring")
+            return True
+        except OSError as e:
+            logger.warning(f"⚠️  Command ring unavailable: {e}")
+            self.ring = None
+            return False
         
     def connect(self, address: str = "ipc:///tmp/tauwerk_midi"):
         """Connect to the C++ MIDI engine"""
         try:
-            self.socket = self.context.socket(zmq.PAIR)
+            # DEALER: the engine serves several clients through one ROUTER socket
+            self.socket = self.context.socket(zmq.DEALER)
+            self.socket.setsockopt(zmq.LINGER, 0)
+            if self.client_name:
+                self.socket.setsockopt(zmq.ROUTING_ID, self.client_name.encode())
             self.socket.connect(address)
             self.running = True
             logger.info("✅ Connected to MIDI engine")
@@ -31,6 +205,10 @@ class MidiBridge:
         self.running = False
         if self.receiver_thread:
             self.receiver_thread.join()
+        if self.ring:
+            self.ring.close()
+            self.ring = None
+        self.ring_name = None
         if self.socket:
             self.socket.close()
         logger.info("🔌 Disconnected from MIDI engine")
@@ -46,6 +224,27 @@ class MidiBridge:
         self._send_message(message)
         logger.debug(f"🎛️  CC ch:{channel} ctrl:{controller} val:{value}")
         
+    def send_cc14(self, channel: int, controller: int, value: int):
+        """Send 14-bit CC pair: controller 0..31 (MSB) + controller+32 (LSB), value 0..16383"""
+        message = {
+            "type": "cc14",
+            "channel": max(0, min(15, channel)),
+            "controller": max(0, min(31, controller)),
+            "value": max(0, min(16383, value))
+        }
+        self._send_message(message)
+        
+    def send_nrpn(self, channel: int, parameter: int, value: int, hires: bool = True, rpn: bool = False):
+        """Send NRPN (or RPN) - value 0..16383 if hires, else 0..127"""
+        message = {
+            "type": "rpn" if rpn else "nrpn",
+            "channel": max(0, min(15, channel)),
+            "parameter": max(0, min(16383, parameter)),
+            "value": max(0, min(16383 if hires else 127, value)),
+            "hires": hires
+        }
+        self._send_message(message)
+        
     def send_note_on(self, channel: int, note: int, velocity: int = 100):
         """Send MIDI Note On message"""
         message = {
@@ -71,6 +270,16 @@ class MidiBridge:
         self._send_message(message)
         logger.info(f"🎶 BPM set to {bpm}")
         
+    def ramp_bpm(self, bpm: float, ticks: int):
+        """Ramp BPM linearly over ticks (24 PPQN) starting at the next clock tick"""
+        message = {
+            "type": "bpm_ramp",
+            "bpm": max(20.0, min(300.0, bpm)),
+            "ticks": max(0, int(ticks))
+        }
+        self._send_message(message)
+        logger.info(f"🎶 BPM ramp to {bpm} over {ticks} ticks")
+        
     def set_clock_mode(self, mode: int):
         """Set clock mode: 0=internal, 1=master, 2=slave"""
         message = {
@@ -92,39 +301,256 @@ class MidiBridge:
         self._send_message(message)
         logger.info("⏹️  Clock stopped")
         
+    def mpe_config(self, channels: int = 15, bend_range: int = 48):
+        """Configure MPE lower zone (member channels 1..channels)"""
+        self._send_message({"type": "mpe_config", "channels": max(0, min(15, channels)),
+                            "bend_range": max(1, min(96, bend_range))})
+        
+    def mpe_note_on(self, voice: int, note: int, velocity: int = 100, bend: float = 0.0, timbre: float = 0.5):
+        """MPE note on - voice is any stable id, e.g. the touch slot"""
+        self._send_message({"type": "mpe_on", "voice": voice, "note": max(0, min(127, note)),
+                            "velocity": max(1, min(127, velocity)), "bend": bend, "timbre": timbre})
+        
+    def mpe_expression(self, voice: int, bend: float, pressure: float, timbre: float):
+        """Per-note expression: bend -1..1, pressure/timbre 0..1"""
+        self._send_message({"type": "mpe_expr", "voice": voice, "bend": bend,
+                            "pressure": pressure, "timbre": timbre})
+        
+    def mpe_note_off(self, voice: int, velocity: int = 0):
+        """MPE note off"""
+        self._send_message({"type": "mpe_off", "voice": voice, "velocity": velocity})
+        
+    def set_param(self, param: int, value: float):
+        """Set engine parameter (normalized 0..1): 0=tempo, 1=swing, 2=morph, 3+n=fader n"""
+        message = {
+            "type": "param",
+            "param": max(0, min(63, param)),
+            "value": max(0.0, min(1.0, value))
+        }
+        self._send_message(message)
+        
+    def set_morph_targets(self, targets):
+        """Morph targets as (channel, controller, hires) tuples - discards both snapshots,
+        nothing is sent until A and B are stored and the morph position moves"""
+        self._send_message({"type": "morph_targets",
+                            "targets": [[int(ch), int(cc), bool(hires)] for ch, cc, hires in targets]})
+        
+    def store_morph_snapshot(self, slot: int, values):
+        """Store snapshot A (slot 0) or B (slot 1), one value 0..1 per target"""
+        self._send_message({"type": "morph_snapshot", "slot": 1 if slot else 0,
+                            "values": [max(0.0, min(1.0, float(v))) for v in values]})
+        
+    def set_morph(self, position: float):
+        """Morph position 0=A .. 1=B"""
+        self.set_param(2, position)
+        
+    def set_lfo(self, index: int, shape: str = "sine", rate: float = 1.0, depth: float = 1.0,
+                center: float = 0.5, phase: float = 0.0, tempo_sync: bool = False,
+                target: Optional[str] = "cc", channel: int = 0, controller: int = 1):
+        """Configure LFO 0..15: rate in Hz, or cycles per beat with tempo_sync"""
+        self._send_message({"type": "lfo", "index": max(0, min(15, index)),
+                            "shape": LFO_SHAPES.index(shape), "target": LFO_TARGETS.index(target),
+                            "channel": channel & 0x0F, "controller": controller & 0x7F,
+                            "tempo_sync": bool(tempo_sync), "rate": max(0.0, float(rate)),
+                            "depth": max(0.0, min(1.0, depth)), "center": max(0.0, min(1.0, center)),
+                            "phase_offset": phase % 1.0})
+        
+    def clear_lfo(self, index: int):
+        """Disable LFO index"""
+        self._send_message({"type": "lfo_clear", "index": max(0, min(15, index))})
+        
+    def set_loop_length(self, bars: float, beats_per_bar: int = 4):
+        """Loop used by automation playback and touch recording (sequencer loop)"""
+        self._send_message({"type": "loop_length",
+                            "ticks": max(1, round(bars * beats_per_bar * CLOCK_PPQN))})
+        
+    def set_automation_lane(self, lane: int, channel: int, controller: int):
+        """Assign automation lane 0..31 to a CC"""
+        self._send_message({"type": "automation_lane", "lane": max(0, min(31, lane)),
+                            "channel": channel & 0x0F, "controller": controller & 0x7F})
+        
+    def clear_automation(self, lane: int):
+        """Remove all points of a lane"""
+        self._send_message({"type": "automation_clear", "lane": max(0, min(31, lane))})
+        
+    def set_automation_points(self, lane: int, points):
+        """Replace a lane's points: (position in clock ticks, value 0..1) tuples"""
+        self._send_message({"type": "automation_points", "lane": max(0, min(31, lane)),
+                            "points": [[max(0, round(tick * AUTOMATION_SUBTICKS)),
+                                        round(max(0.0, min(1.0, value)) * 16383)] for tick, value in points]})
+        
+    def arm_automation(self, lane: int, armed: bool = True):
+        """Touch record: while armed, write_automation() values replace the lane"""
+        self._send_message({"type": "automation_arm", "lane": max(0, min(31, lane)), "armed": bool(armed)})
+        
+    def write_automation(self, lane: int, value: float):
+        """Live value 0..1 (sent as CC, recorded while armed and the clock runs)"""
+        self._send_message({"type": "automation_write", "lane": max(0, min(31, lane)),
+                            "value": max(0.0, min(1.0, value))})
+        
+    def learn(self, param: int):
+        """Arm MIDI learn: next moved controller/note is mapped to param"""
+        message = {"type": "learn", "param": max(0, min(63, param))}
+        self._send_message(message)
+        logger.info(f"🎓 MIDI learn armed for param {param}")
+        
+    def cancel_learn(self):
+        """Cancel pending MIDI learn"""
+        self._send_message({"type": "learn_cancel"})
+        
+    def get_session_stats(self, timeout_ms: int = 500) -> Optional[dict]:
+        """Per-client statistics from the engine (own session id + all clients)"""
+        if not self.socket:
+            return None
+        try:
+            self.socket.send(struct.pack("<BBH", IPC_VERSION, _CMD_STATS, 4))
+            if self.socket.poll(timeout_ms, zmq.POLLIN):
+                return json.loads(self.socket.recv())
+        except Exception as e:
+            logger.error(f"Stats error: {e}")
+        return None
+        
     def add_callback(self, callback: Callable[[dict], None]):
         """Add callback for received messages"""
         self.callbacks.append(callback)
         logger.debug(f"📨 Added MIDI callback (total: {len(self.callbacks)})")
         
-    def start_receiver(self):
-        """Start receiving thread"""
+    def start_receiver(self, address: str = "ipc:///tmp/tauwerk_midi_events"):
+        """Subscribe to engine telemetry (src/midi/telemetry.hpp)
+
+        Callbacks receive each event dict ("midi", "midi2", "transport") and
+        conflated state snapshots as {"type": "state", ...}. The latest state
+        is also kept in self.state. Parameter changes (e.g. swing or a fader
+        moved via MIDI learn) arrive as {"type": "param", "param", "value"},
+        current values are in self.params.
+        """
         def receiver_loop():
+            sub = self.context.socket(zmq.SUB)
+            sub.setsockopt(zmq.RCVHWM, 64)
+            sub.setsockopt(zmq.LINGER, 0)
+            sub.connect(address)
+            sub.setsockopt(zmq.SUBSCRIBE, b"state")
+            sub.setsockopt(zmq.SUBSCRIBE, b"events")
+            poller = zmq.Poller()
+            poller.register(sub, zmq.POLLIN)
+            
             while self.running:
                 try:
-                    message_str = self.socket.recv_string(zmq.NOBLOCK)
-                    message = json.loads(message_str)
+                    # Timeout only so disconnect() is noticed
+                    if not poller.poll(100):
+                        continue
+                    topic, body = sub.recv_multipart(zmq.NOBLOCK)
+                    if topic == b"state":
+                        self.state = json.loads(body)
+                        messages = self._param_changes(self.state.get("params", []))
+                        messages.append(dict(self.state, type="state"))
+                    else:
+                        messages = json.loads(body)
                     
-                    for callback in self.callbacks:
-                        try:
-                            callback(message)
-                        except Exception as e:
-                            logger.error(f"Callback error: {e}")
-                            
+                    for message in messages:
+                        for callback in self.callbacks:
+                            try:
+                                callback(message)
+                            except Exception as e:
+                                logger.error(f"Callback error: {e}")
+                                
                 except zmq.Again:
                     pass
                 except Exception as e:
                     logger.error(f"Receiver error: {e}")
+            sub.close()
                     
         self.receiver_thread = threading.Thread(target=receiver_loop, daemon=True)
         self.receiver_thread.start()
         logger.info("📡 Started MIDI message receiver")
         
+    def _param_changes(self, params) -> list:
+        """Param events for every value that differs from the last state"""
+        changes = [{"type": "param", "param": i, "value": v}
+                   for i, v in enumerate(params)
+                   if i >= len(self.params) or self.params[i] != v]
+        self.params = list(params)
+        return changes
+
+    @contextmanager
+    def batch(self):
+        """Collect all commands of the block into one frame (e.g. fader sweeps)"""
+        if self._batch is not None:
+            yield self
+            return
+        self._batch = []
+        try:
+            yield self
+        finally:
+            records, self._batch = self._batch, None
+            if records and self.socket:
+                try:
+                    self.socket.send(b"".join(records))
+                except Exception as e:
+                    logger.error(f"Send error: {e}")
+        
+    def _reopen_ring(self, now: float) -> bool:
+        """Attach the ring of a (re)started engine, rate limited"""
+        if not self.ring_name or now < self._ring_retry_at:
+            return False
+        self._ring_retry_at = now + self.RING_RETRY_S
+        try:
+            self.ring = CommandRing(self.ring_name)
+            logger.info("⚡ Command ring reopened")
+            return True
+        except OSError:
+            return False
+        
+    def _push_ring(self, message: dict) -> bool:
+        mtype = message["type"]
+        if mtype == "cc":
+            return self.ring.cc(message["channel"], message["controller"], message["value"])
+        if mtype == "note":
+            return self.ring.note(message["channel"], message["note"], message["velocity"])
+        if mtype == "cc14":
+            return self.ring.cc14(message["channel"], message["controller"], message["value"])
+        if mtype in ("nrpn", "rpn"):
+            return self.ring.nrpn(message["channel"], message["parameter"], message["value"],
+                                  message.get("hires", True), mtype == "rpn")
+        if mtype == "param":
+            return self.ring.param(message["param"], message["value"])
+        return self.ring.automation(message["lane"], message["value"])
+        
+    def _send_ring(self, message: dict) -> bool:
+        """Hot commands via the shared-memory ring, False = use ZMQ"""
+        if message["type"] not in self.RING_TYPES:
+            return False
+        now = time.monotonic()
+        if now < self._ring_full_until:
+            # Ring overflowed in this burst: the rest follows over ZMQ, or it would overtake
+            self._ring_full_until = now + self.RING_FALLBACK_S
+            return False
+        if self.ring is None and not self._reopen_ring(now):
+            return False
+        if self._push_ring(message):
+            return True
+        if self.ring.closed:
+            logger.warning("⚠️  Command ring closed by the engine - reopening")
+            self.ring.close()
+            self.ring = None
+            self._ring_retry_at = 0.0
+            return self._reopen_ring(now) and self._push_ring(message)
+        self._ring_full_until = now + self.RING_FALLBACK_S
+        return False
+        
     def _send_message(self, message: dict):
-        """Internal message sender"""
+        """Internal message sender - ring for hot commands, binary record, JSON in debug mode"""
+        if self.ring_name and not self.use_json and self._batch is None and self._send_ring(message):
+            return
         if self.socket:
             try:
-                self.socket.send_string(json.dumps(message))
+                record = None if self.use_json else encode_record(message)
+                if record is not None and self._batch is not None:
+                    self._batch.append(record)
+                elif record is not None:
+                    self.socket.send(record)
+                else:
+                    self.socket.send_string(json.dumps(message))
             except Exception as e:
                 logger.error(f"Send error: {e}")
         else:
@@ -4,11 +4,13 @@ Tauwerk UI Bridge - Shared Memory Kommunikation zwischen Python und C++
 """
 
 import mmap
+import os
 import struct
 import time
 from typing import List, Optional
 from ctypes import Structure, c_int, c_char, c_bool, sizeof
 from enum import Enum
+import doorbell
 
 class UIElementType(Enum):
     BUTTON = 0
@@ -46,6 +48,11 @@ class UIEvent(Structure):
     ]
 
 class TauwerkUIBridge:
+    DOORBELL_PATH = "/tmp/tauwerk_ui_doorbell"
+    COMMAND_SHM = "/dev/shm/tauwerk_ui_commands"
+    EVENT_SHM = "/dev/shm/tauwerk_ui_events"
+    MAGIC = 0x54415557      # control[2] beider Segmente, gesetzt vom Treiber
+
     def __init__(self):
         self.command_shm = None
         self.event_shm = None
@@ -54,28 +61,87 @@ class TauwerkUIBridge:
         self.buffer_size = 256
         self.command_write_index = 0
         self.event_read_index = 0
+        self.command_file = None
+        self.event_file = None
+        self.remap_at = 0.0     # nächste Prüfung, ob die Segmente noch aktuell sind
+        self.warned = False
+        # Treiber neu gestartet: er kennt keine Elemente mehr - hier neu anlegen
+        self.on_reconnect = None
+        self.doorbell = doorbell.Doorbell(self.DOORBELL_PATH, "UI",
+                                          on_reconnect=self._reconnect,
+                                          active=lambda: self.event_buffer is not None)
         
     def connect(self):
         """Verbinde mit C++ UI Treiber"""
+        if not self._map():
+            return False
+        self.doorbell.connect()
+        return True
+
+    def _map(self):
+        """(Neu) abbilden - stop() des Treibers entfernt beide Segmente"""
+        self._unmap()
+        self.remap_at = time.monotonic() + doorbell.RETRY_S
         try:
             # Command Buffer (Python → C++)
-            cmd_shm_fd = open("/dev/shm/tauwerk_ui_commands", "r+b")
-            self.command_shm = mmap.mmap(cmd_shm_fd.fileno(), 0)
+            self.command_file = open(self.COMMAND_SHM, "r+b")
+            self.command_shm = mmap.mmap(self.command_file.fileno(), 0)
             
             # Event Buffer (C++ → Python)  
-            event_shm_fd = open("/dev/shm/tauwerk_ui_events", "r+b") 
-            self.event_shm = mmap.mmap(event_shm_fd.fileno(), 0)
+            self.event_file = open(self.EVENT_SHM, "r+b")
+            self.event_shm = mmap.mmap(self.event_file.fileno(), 0)
+
+            cmd_control = self.buffer_size * sizeof(PythonCommand)
+            event_control = self.buffer_size * sizeof(UIEvent)
+            if len(self.command_shm) < cmd_control + 12 or len(self.event_shm) < event_control + 12 \
+                    or struct.unpack_from('I', self.command_shm, cmd_control + 8)[0] != self.MAGIC \
+                    or struct.unpack_from('I', self.event_shm, event_control + 8)[0] != self.MAGIC:
+                raise RuntimeError("shared memory not initialized")
             
             # Buffer als Arrays von Structures mappen
             self.command_buffer = (PythonCommand * self.buffer_size).from_buffer(self.command_shm)
             self.event_buffer = (UIEvent * self.buffer_size).from_buffer(self.event_shm)
+
+            # Indizes aus dem Segment: frisch vom Treiber 0, sonst weiter wo er steht
+            self.command_write_index = struct.unpack_from('I', self.command_shm, cmd_control)[0]
+            self.event_read_index = struct.unpack_from('I', self.event_shm, event_control + 4)[0]
             
+            self.warned = False
             print("✅ Connected to C++ UI Driver")
             return True
             
         except Exception as e:
-            print(f"❌ UI Bridge connection failed: {e}")
+            # Nur einmal melden - ohne Treiber wird alle RETRY_S neu versucht
+            if not self.warned:
+                print(f"❌ UI Bridge connection failed: {e}")
+                self.warned = True
+            self._unmap()
             return False
+
+    def _unmap(self):
+        # Erst die ctypes-Arrays freigeben, sonst lässt sich das mmap nicht schließen
+        self.command_buffer = None
+        self.event_buffer = None
+        for name in ('command_shm', 'event_shm', 'command_file', 'event_file'):
+            if getattr(self, name):
+                getattr(self, name).close()
+                setattr(self, name, None)
+
+    def _reconnect(self):
+        """Doorbell neu verbunden = Treiber (neu) gestartet: neu abbilden, Elemente anlegen"""
+        if self._map() and self.on_reconnect:
+            self.on_reconnect()
+
+    def _check_segments(self):
+        """Höchstens alle RETRY_S: fehlen die Segmente oder wurden sie entfernt
+        (Treiber beendet), neu abbilden. Elemente legt erst _reconnect an"""
+        if time.monotonic() < self.remap_at:
+            return
+        self.remap_at = time.monotonic() + doorbell.RETRY_S
+        if self.event_buffer is None \
+                or os.fstat(self.command_file.fileno()).st_nlink == 0 \
+                or os.fstat(self.event_file.fileno()).st_nlink == 0:
+            self._map()
     
     def create_button(self, element_id: int, x: int, y: int, width: int, height: int, 
                      text: str = "", color: int = 0x5A825A):
@@ -201,6 +267,7 @@ class TauwerkUIBridge:
     def get_events(self) -> List[UIEvent]:
         """Lese Events von C++ Treiber"""
         events = []
+        self._check_segments()
         if not self.event_buffer:
             return events
             
@@ -219,12 +286,14 @@ class TauwerkUIBridge:
         
         return events
     
+    def fileno(self):
+        """Doorbell-eventfd für select (-1 = keine Doorbell, pollen)"""
+        return self.doorbell.fileno()
+
     def close(self):
         """Schließe Verbindung"""
-        if self.command_shm:
-            self.command_shm.close()
-        if self.event_shm:
-            self.event_shm.close()
+        self.doorbell.close()
+        self._unmap()
         print("🔌 UI Bridge disconnected")
 
 # Test der Bridge
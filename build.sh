@@ -24,3 +24,7 @@ g++ -o ./bin/test ./src/test.cpp \
     -O3 -std=c++17
 chmod +x ./bin/test
 echo "- bin/test"
+
+make midi commands-lib
+echo "- bin/tauwerk_midi"
+echo "- bin/libtauwerk_midi_commands.so"
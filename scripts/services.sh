@@ -10,12 +10,14 @@ if [ "$1" == "stop" ]; then
     sudo systemctl stop tauwerk.service 2>/dev/null || true
     sudo systemctl stop tauwerk_touchpad.service 2>/dev/null || true
     sudo systemctl stop tauwerk_gpio.service 2>/dev/null || true
+    sudo systemctl stop tauwerk_midi.service 2>/dev/null || true
     echo "✅ All services stopped"
     exit 0
 fi
 
 if [ "$1" == "start" ]; then
     echo "▶️  Starting all Tauwerk services..."
+    sudo systemctl start tauwerk_midi.service
     sudo systemctl start tauwerk_gpio.service
     sudo systemctl start tauwerk_touchpad.service
     sudo systemctl start tauwerk.service
@@ -25,6 +27,7 @@ fi
 
 if [ "$1" == "restart" ]; then
     echo "🔄 Restarting all Tauwerk services..."
+    sudo systemctl restart tauwerk_midi.service
     sudo systemctl restart tauwerk_gpio.service
     sudo systemctl restart tauwerk_touchpad.service
     sudo systemctl restart tauwerk.service
@@ -35,6 +38,9 @@ fi
 if [ "$1" == "status" ]; then
     echo "📊 Service Status:"
     echo ""
+    echo "━━━ MIDI Engine ━━━"
+    sudo systemctl status tauwerk_midi.service --no-pager -l
+    echo ""
     echo "━━━ GPIO Driver ━━━"
     sudo systemctl status tauwerk_gpio.service --no-pager -l
     echo ""
@@ -48,13 +54,13 @@ fi
 
 if [ "$1" == "logs" ]; then
     echo "📋 Live Logs (Ctrl+C to exit):"
-    sudo journalctl -u tauwerk_gpio.service -u tauwerk_touchpad.service -u tauwerk.service -f
+    sudo journalctl -u tauwerk_midi.service -u tauwerk_gpio.service -u tauwerk_touchpad.service -u tauwerk.service -f
     exit 0
 fi
 
 if [ "$1" == "errors" ]; then
     echo "❌ Error Logs (last 50 lines):"
-    sudo journalctl -u tauwerk_gpio.service -u tauwerk_touchpad.service -u tauwerk.service -p err -n 50
+    sudo journalctl -u tauwerk_midi.service -u tauwerk_gpio.service -u tauwerk_touchpad.service -u tauwerk.service -p err -n 50
     exit 0
 fi
 
@@ -121,12 +127,42 @@ WantedBy=multi-user.target
 EOF
 echo "  ✅ tauwerk_gpio.service created"
 
+# MIDI Engine Service (Type=notify: READY erst nach mlockall + ALSA + IPC)
+sudo tee /etc/systemd/system/tauwerk_midi.service > /dev/null <<EOF
+[Unit]
+Description=Tauwerk MIDI Engine (Realtime)
+After=sound.target
+Before=tauwerk.service
+
+[Service]
+Type=notify
+User=tauwerk
+WorkingDirectory=/home/tauwerk
+ExecStart=/home/tauwerk/bin/tauwerk_midi --config /home/tauwerk/config/hardware.ini
+Restart=always
+RestartSec=3
+TimeoutStopSec=5
+StandardOutput=journal
+StandardError=journal
+
+SupplementaryGroups=audio
+
+# Echtzeit: SCHED_FIFO-Threads setzt die Engine selbst (rt_priority in hardware.ini)
+LimitRTPRIO=95
+LimitMEMLOCK=infinity
+OOMScoreAdjust=-1000
+
+[Install]
+WantedBy=multi-user.target
+EOF
+echo "  ✅ tauwerk_midi.service created"
+
 # Main Application Service
 sudo tee /etc/systemd/system/tauwerk.service > /dev/null <<EOF
 [Unit]
 Description=Tauwerk Sequencer
-After=tauwerk_gpio.service tauwerk_touchpad.service
-Wants=tauwerk_gpio.service tauwerk_touchpad.service
+After=tauwerk_midi.service tauwerk_gpio.service tauwerk_touchpad.service
+Wants=tauwerk_midi.service tauwerk_gpio.service tauwerk_touchpad.service
 Requires=tauwerk_touchpad.service
 
 [Service]
@@ -154,6 +190,7 @@ echo "🔄 Reloading systemd..."
 sudo systemctl daemon-reload
 
 echo "🔗 Enabling services..."
+sudo systemctl enable tauwerk_midi.service
 sudo systemctl enable tauwerk_gpio.service
 sudo systemctl enable tauwerk_touchpad.service
 sudo systemctl enable tauwerk.service
@@ -0,0 +1,188 @@
+#ifndef TAUWERK_DOORBELL_HPP
+#define TAUWERK_DOORBELL_HPP
+
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+// 🔔 Doorbell für Leser eines Shared-Memory Rings (GPIO- und Touch-Treiber)
+//
+// Unix-Socket, jeder Client bekommt beim Verbinden ein eigenes eventfd
+// (SCM_RIGHTS) für sein select/epoll. Der Treiber meldet neue Events mit
+// notify() und klingelt einmal pro Durchlauf mit ring(), nicht pro Event.
+// Clients schicken nichts - ist ihr Socket lesbar, ist die Verbindung zu.
+// Gegenstück in Python: app/doorbell.py
+class DoorbellServer {
+public:
+    static constexpr size_t MAX_CLIENTS = 8;
+
+    explicit DoorbellServer(const char* path) : path_(path) {}
+    ~DoorbellServer() { close(); }
+
+    DoorbellServer(const DoorbellServer&) = delete;
+    DoorbellServer& operator=(const DoorbellServer&) = delete;
+
+    // Lauscht nicht-blockierend auf path_. watch: optional, z.B. ins epoll aufnehmen
+    bool open(const std::function<bool(int)>& watch = nullptr) {
+        fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+        if (fd_ < 0) {
+            std::cerr << "❌ Doorbell socket failed: " << strerror(errno) << std::endl;
+            return false;
+        }
+
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, path_, sizeof(addr.sun_path) - 1);
+        unlink(path_);
+        if (bind(fd_, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+            listen(fd_, 4) < 0 || (watch && !watch(fd_))) {
+            std::cerr << "❌ Doorbell setup failed: " << strerror(errno) << std::endl;
+            ::close(fd_);
+            fd_ = -1;
+            return false;
+        }
+        chmod(path_, 0666);   // wie die Shared-Memory Segmente
+        std::cout << "🔔 Doorbell on " << path_ << std::endl;
+        return true;
+    }
+
+    int fd() const { return fd_; }
+    uint64_t rings() const { return rings_; }
+
+    // Neue Leser annehmen: eigenes eventfd anlegen und übergeben
+    void accept(const std::function<bool(int)>& watch = nullptr) {
+        if (fd_ < 0) return;
+        int sock;
+        while ((sock = accept4(fd_, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK)) >= 0) {
+            if (clients_.size() >= MAX_CLIENTS) {
+                std::cerr << "⚠️  Doorbell: too many clients" << std::endl;
+                ::close(sock);
+                continue;
+            }
+
+            int efd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+            if (efd < 0 || !send_fd(sock, efd) || (watch && !watch(sock))) {
+                std::cerr << "⚠️  Doorbell: client setup failed" << std::endl;
+                if (efd >= 0) ::close(efd);
+                ::close(sock);
+                continue;
+            }
+            clients_.push_back({sock, efd});
+            std::cout << "🔔 Doorbell client connected (" << clients_.size() << ")" << std::endl;
+        }
+    }
+
+    // Client-Socket lesbar (epoll): bei EOF abbauen. false = kein Client-Socket
+    bool handle_client(int sock) {
+        for (size_t i = 0; i < clients_.size(); i++) {
+            if (clients_[i].sock != sock) continue;
+            if (closed(sock)) drop(i);
+            return true;
+        }
+        return false;
+    }
+
+    // Ohne epoll, einmal pro Durchlauf: annehmen und geschlossene abbauen
+    void service() {
+        accept();
+        for (size_t i = 0; i < clients_.size();) {
+            if (closed(clients_[i].sock)) {
+                drop(i);
+            } else {
+                i++;
+            }
+        }
+    }
+
+    void notify() { pending_ = true; }
+
+    // Einmal pro Durchlauf: neue Events seit dem letzten Klingeln?
+    void ring() {
+        if (!pending_) return;
+        pending_ = false;
+        if (clients_.empty()) return;
+
+        uint64_t one = 1;
+        for (const auto& client : clients_) {
+            if (write(client.efd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+                std::cerr << "⚠️  Doorbell write failed: " << strerror(errno) << std::endl;
+            }
+        }
+        rings_++;
+    }
+
+    void close() {
+        for (const auto& client : clients_) {
+            ::close(client.sock);
+            ::close(client.efd);
+        }
+        clients_.clear();
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+            unlink(path_);
+        }
+    }
+
+private:
+    struct Client {
+        int sock;
+        int efd;
+    };
+
+    static bool send_fd(int sock, int fd) {
+        char byte = 'D';
+        struct iovec iov = {&byte, 1};
+        union {
+            char buf[CMSG_SPACE(sizeof(int))];
+            struct cmsghdr align;
+        } control;
+        memset(&control, 0, sizeof(control));
+
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control.buf;
+        msg.msg_controllen = sizeof(control.buf);
+
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+        return sendmsg(sock, &msg, MSG_NOSIGNAL) == 1;
+    }
+
+    // EOF oder Fehler; Daten (unerwartet) werden verworfen
+    static bool closed(int sock) {
+        char buf[16];
+        ssize_t n = recv(sock, buf, sizeof(buf), MSG_DONTWAIT);
+        return n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR);
+    }
+
+    // close() nimmt den Socket auch aus einem epoll
+    void drop(size_t i) {
+        ::close(clients_[i].sock);
+        ::close(clients_[i].efd);
+        clients_.erase(clients_.begin() + i);
+        std::cout << "🔔 Doorbell client disconnected (" << clients_.size() << ")" << std::endl;
+    }
+
+    const char* path_;
+    int fd_ = -1;
+    std::vector<Client> clients_;
+    bool pending_ = false;
+    uint64_t rings_ = 0;
+};
+
+#endif
@@ -0,0 +1,179 @@
+#include "automation.hpp"
+#include <algorithm>
+
+bool AutomationEngine::setLane(int lane, uint8_t channel, uint8_t controller) {
+    if (lane < 0 || lane >= MAX_LANES) return false;
+    
+    std::lock_guard<std::mutex> lock(edit_mutex_);
+    EditState& edit = edit_[lane];
+    edit.assigned = true;
+    edit.channel = channel & 0x0F;
+    edit.controller = controller & 0x7F;
+    targets_[lane].store(static_cast<uint16_t>(TARGET_ASSIGNED | edit.channel << 7 | edit.controller));
+    publish(lane);
+    return true;
+}
+
+bool AutomationEngine::clearLane(int lane) {
+    if (lane < 0 || lane >= MAX_LANES) return false;
+    
+    std::lock_guard<std::mutex> lock(edit_mutex_);
+    edit_[lane].points.clear();
+    edit_[lane].last_record = -1;
+    publish(lane);
+    return true;
+}
+
+bool AutomationEngine::setPoints(int lane, std::vector<AutomationPoint> points) {
+    if (lane < 0 || lane >= MAX_LANES) return false;
+    
+    std::stable_sort(points.begin(), points.end(),
+        [](const AutomationPoint& a, const AutomationPoint& b) { return a.subtick < b.subtick; });
+    
+    std::lock_guard<std::mutex> lock(edit_mutex_);
+    edit_[lane].points = std::move(points);
+    publish(lane);
+    return true;
+}
+
+std::vector<AutomationPoint> AutomationEngine::points(int lane) const {
+    if (lane < 0 || lane >= MAX_LANES) return {};
+    
+    std::lock_guard<std::mutex> lock(edit_mutex_);
+    return edit_[lane].points;
+}
+
+bool AutomationEngine::target(int lane, uint8_t& channel, uint8_t& controller) const {
+    if (lane < 0 || lane >= MAX_LANES) return false;
+    
+    uint16_t target = targets_[lane].load(std::memory_order_relaxed);
+    if (!(target & TARGET_ASSIGNED)) return false;
+    channel = (target >> 7) & 0x0F;
+    controller = target & 0x7F;
+    return true;
+}
+
+void AutomationEngine::arm(int lane, bool armed) {
+    if (lane < 0 || lane >= MAX_LANES) return;
+    
+    // Vorgemerkte Touches gehören noch zur laufenden Aufnahme
+    if (!armed) applyTouches();
+    if (armed_[lane].exchange(armed) != armed) {
+        armed_count_.fetch_add(armed ? 1 : -1, std::memory_order_relaxed);
+    }
+    if (!armed) {
+        std::lock_guard<std::mutex> lock(edit_mutex_);
+        edit_[lane].last_record = -1;
+    }
+}
+
+// ⏺ Ersetzt alle Punkte seit dem letzten Record-Aufruf (Touch-Mode), inkl. Loop-Wrap
+bool AutomationEngine::record(int lane, uint32_t subtick, uint32_t loop_subticks, uint16_t value) {
+    if (lane < 0 || lane >= MAX_LANES || !armed_[lane].load()) return false;
+    
+    std::lock_guard<std::mutex> lock(edit_mutex_);
+    EditState& edit = edit_[lane];
+    if (!edit.assigned) return false;
+    
+    auto& pts = edit.points;
+    int64_t from = edit.last_record;
+    
+    auto erase_range = [&pts](int64_t lo, int64_t hi) {  // (lo, hi]
+        pts.erase(std::remove_if(pts.begin(), pts.end(),
+            [lo, hi](const AutomationPoint& p) { return p.subtick > lo && p.subtick <= hi; }),
+            pts.end());
+    };
+    
+    if (from < 0) {
+        erase_range(static_cast<int64_t>(subtick) - 1, subtick);
+    } else if (from <= subtick) {
+        erase_range(from, subtick);
+    } else {
+        erase_range(from, loop_subticks);
+        erase_range(-1, subtick);
+    }
+    
+    AutomationPoint point{subtick, static_cast<uint16_t>(value & 0x3FFF), 0};
+    auto pos = std::upper_bound(pts.begin(), pts.end(), point,
+        [](const AutomationPoint& a, const AutomationPoint& b) { return a.subtick < b.subtick; });
+    pts.insert(pos, point);
+    
+    edit.last_record = subtick;
+    publish(lane);
+    return true;
+}
+
+bool AutomationEngine::touch(int lane, uint32_t subtick, uint32_t loop_subticks, uint16_t value) {
+    if (lane < 0 || lane >= MAX_LANES || !armed_[lane].load(std::memory_order_relaxed)) return false;
+    return touches_.push(Touch{lane, subtick, loop_subticks, value});
+}
+
+int AutomationEngine::applyTouches() {
+    int count = 0;
+    Touch t;
+    while (touches_.pop(t)) {
+        if (record(t.lane, t.subtick, t.loop_subticks, t.value)) count++;
+    }
+    return count;
+}
+
+// Editor-Mutex muss gehalten sein
+void AutomationEngine::publish(int lane) {
+    const EditState& edit = edit_[lane];
+    if (!edit.assigned) return;
+    
+    lanes_[lane].publish(new LaneData{edit.channel, edit.controller, edit.points});
+}
+
+uint16_t AutomationEngine::evaluate(const LaneData& data, PlayState& state, double position) {
+    const auto& pts = data.points;
+    
+    // Loop-Wrap oder neuer Buffer -> Cursor zurücksetzen
+    if (position < state.last_position || state.cursor >= pts.size()) {
+        state.cursor = 0;
+    }
+    state.last_position = position;
+    
+    while (state.cursor + 1 < pts.size() && pts[state.cursor + 1].subtick <= position) {
+        state.cursor++;
+    }
+    
+    const AutomationPoint& a = pts[state.cursor];
+    if (position <= a.subtick || state.cursor + 1 >= pts.size()) {
+        return a.value;
+    }
+    
+    const AutomationPoint& b = pts[state.cursor + 1];
+    double t = (position - a.subtick) / static_cast<double>(b.subtick - a.subtick);
+    return static_cast<uint16_t>(a.value + (static_cast<double>(b.value) - a.value) * t + 0.5);
+}
+
+int AutomationEngine::process(double position_subticks, int64_t now_ns, MidiMessage* out) {
+    int count = 0;
+    
+    for (int lane = 0; lane < MAX_LANES; lane++) {
+        PlayState& state = play_[lane];
+        const LaneData* data = lanes_[lane].acquire();
+        
+        if (data != state.data) {
+            state.data = data;
+            state.cursor = 0;
+            state.last_position = -1.0;
+        }
+        if (!data || data->points.empty()) continue;
+        
+        // Touch: Live-Fader hat Vorrang
+        if (armed_[lane].load(std::memory_order_relaxed)) {
+            state.last_sent = -1;
+            continue;
+        }
+        
+        int32_t value = evaluate(*data, state, position_subticks) >> 7;  // 14 -> 7 bit
+        if (value == state.last_sent) continue;
+        state.last_sent = value;
+        
+        out[count++] = MidiMessage(0xB0 | data->channel, data->controller, value, now_ns);
+    }
+    
+    return count;
+}
@@ -0,0 +1,102 @@
+#ifndef AUTOMATION_HPP
+#define AUTOMATION_HPP
+
+#include "midi_message.hpp"
+#include "rt_swap.hpp"
+#include <boost/lockfree/spsc_queue.hpp>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Breakpoint: Position in Subticks (1/16 Clock-Tick = 384 PPQN), 14-bit Wert
+struct AutomationPoint {
+    uint32_t subtick;
+    uint16_t value;
+    uint16_t reserved;
+};
+
+// 🎚 Automation-Lanes pro Parameter
+//
+// Editor-Seite (API/IPC-Thread) hält eine bearbeitbare Kopie pro Lane und
+// veröffentlicht nach jeder Änderung einen neuen, unveränderlichen Buffer
+// über RtSwap. Der Clock-Thread interpoliert nur - ohne Allokation, mit
+// Cursor pro Lane (amortisiert O(1) pro Auswertung).
+//
+// Touch-Writes aus dem Kommando-Ring (Output-Thread) dürfen weder sperren
+// noch allozieren: touch() reiht nur ein, applyTouches() im Editor-Thread
+// schreibt die Punkte.
+class AutomationEngine {
+public:
+    static constexpr int MAX_LANES = 32;
+    static constexpr int SUBTICKS = 16;
+    
+    // Editor-Thread
+    bool setLane(int lane, uint8_t channel, uint8_t controller);
+    bool clearLane(int lane);
+    bool setPoints(int lane, std::vector<AutomationPoint> points);
+    std::vector<AutomationPoint> points(int lane) const;
+    bool target(int lane, uint8_t& channel, uint8_t& controller) const;  // lock-frei
+    
+    // Touch-Record: solange armed, hat der Live-Wert Vorrang vor der Wiedergabe
+    void arm(int lane, bool armed);
+    bool armed() const { return armed_count_.load(std::memory_order_relaxed) > 0; }
+    bool record(int lane, uint32_t subtick, uint32_t loop_subticks, uint16_t value);
+    
+    // RT-Thread (ein Producer): Record für applyTouches() vormerken
+    bool touch(int lane, uint32_t subtick, uint32_t loop_subticks, uint16_t value);
+    int applyTouches();
+    
+    // Clock-Thread: schreibt max. MAX_LANES Messages nach out
+    int process(double position_subticks, int64_t now_ns, MidiMessage* out);
+
+private:
+    struct LaneData {
+        uint8_t channel;
+        uint8_t controller;
+        std::vector<AutomationPoint> points;  // sortiert nach subtick
+    };
+    
+    struct EditState {
+        bool assigned = false;
+        uint8_t channel = 0;
+        uint8_t controller = 0;
+        std::vector<AutomationPoint> points;
+        int64_t last_record = -1;
+    };
+    
+    struct Touch {
+        int lane;
+        uint32_t subtick;
+        uint32_t loop_subticks;
+        uint16_t value;
+    };
+    
+    struct PlayState {
+        const LaneData* data = nullptr;
+        size_t cursor = 0;
+        double last_position = -1.0;
+        int32_t last_sent = -1;
+    };
+    
+    void publish(int lane);
+    uint16_t evaluate(const LaneData& data, PlayState& state, double position);
+    
+    // Editor
+    mutable std::mutex edit_mutex_;
+    EditState edit_[MAX_LANES];
+    
+    // Übergabe
+    RtSwap<LaneData> lanes_[MAX_LANES];
+    std::atomic<bool> armed_[MAX_LANES] = {};
+    std::atomic<int> armed_count_{0};
+    std::atomic<uint16_t> targets_[MAX_LANES] = {};    // TARGET_ASSIGNED | channel << 7 | controller
+    boost::lockfree::spsc_queue<Touch, boost::lockfree::capacity<256>> touches_;
+    
+    static constexpr uint16_t TARGET_ASSIGNED = 0x8000;
+    
+    // Clock-Thread
+    PlayState play_[MAX_LANES];
+};
+
+#endif
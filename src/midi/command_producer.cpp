@@ -0,0 +1,130 @@
+// command_producer.cpp - C-ABI Producer für den MIDI-Kommando-Ring
+//
+// Wird als bin/libtauwerk_midi_commands.so gebaut und von app/midi.py per
+// ctypes geladen. Ein Handle = ein Producer: nur aus einem Thread benutzen.
+// Rückgabe der Sende-Funktionen: 0 = OK, -1 = Ring voll / ungültig,
+// -2 = Engine hat den Ring geschlossen (neu öffnen).
+
+#include "command_ring.hpp"
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+struct Producer {
+    command_ring::Header* header;
+    command_ring::Slot* slots;
+};
+
+template <typename Record>
+int pushRecord(Producer* producer, ipc::Command command, Record& record) {
+    if (!producer) return -1;
+    if (!producer->header->alive.load(std::memory_order_acquire)) return -2;
+    record.header = ipc::Header{ipc::VERSION, command, sizeof(Record)};
+    return command_ring::push(producer->header, producer->slots, &record, sizeof(Record)) ? 0 : -1;
+}
+
+uint8_t clamp7(int value) {
+    return static_cast<uint8_t>(value < 0 ? 0 : value > 127 ? 127 : value);
+}
+
+int parameter(Producer* producer, ipc::Command command, int channel, int parameter, int value, int hires) {
+    ipc::ParameterRecord r{};
+    r.channel = static_cast<uint8_t>(channel & 0x0F);
+    r.hires = hires ? 1 : 0;
+    r.parameter = static_cast<uint16_t>(parameter & 0x3FFF);
+    r.value = static_cast<uint16_t>(value < 0 ? 0 : value > 16383 ? 16383 : value);
+    return pushRecord(producer, command, r);
+}
+
+} // namespace
+
+extern "C" {
+
+// NULL wenn die Engine den Ring nicht angelegt hat (oder andere Version / geschlossen)
+void* tauwerk_commands_open(const char* name) {
+    int fd = shm_open(name ? name : command_ring::DEFAULT_NAME, O_RDWR, 0);
+    if (fd < 0) return nullptr;
+    void* mem = mmap(nullptr, command_ring::MAP_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) return nullptr;
+
+    auto* header = static_cast<command_ring::Header*>(mem);
+    if (header->magic != command_ring::MAGIC || header->version != command_ring::VERSION ||
+        header->slot_size != command_ring::SLOT_SIZE || header->capacity != command_ring::CAPACITY ||
+        !header->alive.load(std::memory_order_acquire)) {
+        munmap(mem, command_ring::MAP_SIZE);
+        return nullptr;
+    }
+
+    auto* producer = static_cast<Producer*>(std::malloc(sizeof(Producer)));
+    if (!producer) {
+        munmap(mem, command_ring::MAP_SIZE);
+        return nullptr;
+    }
+    producer->header = header;
+    producer->slots = reinterpret_cast<command_ring::Slot*>(header + 1);
+    return producer;
+}
+
+void tauwerk_commands_close(void* handle) {
+    auto* producer = static_cast<Producer*>(handle);
+    if (!producer) return;
+    munmap(producer->header, command_ring::MAP_SIZE);
+    std::free(producer);
+}
+
+unsigned tauwerk_commands_dropped(void* handle) {
+    auto* producer = static_cast<Producer*>(handle);
+    return producer ? producer->header->dropped.load(std::memory_order_relaxed) : 0;
+}
+
+int tauwerk_commands_cc(void* handle, int channel, int controller, int value) {
+    ipc::CcRecord r{};
+    r.channel = static_cast<uint8_t>(channel & 0x0F);
+    r.controller = clamp7(controller);
+    r.value = clamp7(value);
+    return pushRecord(static_cast<Producer*>(handle), ipc::CMD_CC, r);
+}
+
+int tauwerk_commands_note(void* handle, int channel, int note, int velocity) {
+    ipc::NoteRecord r{};
+    r.channel = static_cast<uint8_t>(channel & 0x0F);
+    r.note = clamp7(note);
+    r.velocity = clamp7(velocity);
+    return pushRecord(static_cast<Producer*>(handle), ipc::CMD_NOTE, r);
+}
+
+int tauwerk_commands_cc14(void* handle, int channel, int controller, int value) {
+    ipc::Cc14Record r{};
+    r.channel = static_cast<uint8_t>(channel & 0x0F);
+    r.controller = static_cast<uint8_t>(controller & 0x1F);
+    r.value = static_cast<uint16_t>(value < 0 ? 0 : value > 16383 ? 16383 : value);
+    return pushRecord(static_cast<Producer*>(handle), ipc::CMD_CC14, r);
+}
+
+int tauwerk_commands_nrpn(void* handle, int channel, int param, int value, int hires) {
+    return parameter(static_cast<Producer*>(handle), ipc::CMD_NRPN, channel, param, value, hires);
+}
+
+int tauwerk_commands_rpn(void* handle, int channel, int param, int value, int hires) {
+    return parameter(static_cast<Producer*>(handle), ipc::CMD_RPN, channel, param, value, hires);
+}
+
+int tauwerk_commands_param(void* handle, int param, float value) {
+    ipc::ParamRecord r{};
+    r.param = static_cast<uint8_t>(param);
+    r.value = value;
+    return pushRecord(static_cast<Producer*>(handle), ipc::CMD_PARAM, r);
+}
+
+int tauwerk_commands_automation(void* handle, int lane, float value) {
+    ipc::AutomationWriteRecord r{};
+    r.lane = static_cast<uint8_t>(lane);
+    r.value = value;
+    return pushRecord(static_cast<Producer*>(handle), ipc::CMD_AUTOMATION_WRITE, r);
+}
+
+} // extern "C"
@@ -0,0 +1,138 @@
+#include "command_ring.hpp"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace command_ring {
+
+namespace {
+
+// Shared (nicht FUTEX_PRIVATE): Producer und Consumer in verschiedenen Prozessen
+long futex(std::atomic<uint32_t>* word, int op, uint32_t value, const timespec* timeout) {
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), op, value, timeout, nullptr, 0);
+}
+
+} // namespace
+
+bool push(Header* header, Slot* slots, const void* record, size_t size) {
+    if (size > SLOT_SIZE) return false;
+
+    uint32_t head = header->head.load(std::memory_order_relaxed);
+    uint32_t tail = header->tail.load(std::memory_order_acquire);
+    if (head - tail >= header->capacity) {
+        header->dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    std::memcpy(slots[head & (header->capacity - 1)].data, record, size);
+    // seq_cst: Gegenstück zu sleeping in wait() (Dekker), sonst verpasstes Wecken
+    header->head.store(head + 1, std::memory_order_seq_cst);
+
+    if (header->sleeping.load(std::memory_order_seq_cst)) {
+        header->doorbell.fetch_add(1, std::memory_order_seq_cst);
+        futex(&header->doorbell, FUTEX_WAKE, 1, nullptr);
+    }
+    return true;
+}
+
+Consumer::Consumer() : header_(nullptr), slots_(nullptr), fd_(-1), name_(nullptr), tail_(0) {}
+
+Consumer::~Consumer() {
+    close();
+}
+
+bool Consumer::create(const char* name) {
+    close();
+
+    fd_ = shm_open(name, O_CREAT | O_RDWR, 0666);
+    if (fd_ < 0) {
+        std::cerr << "ERROR: shm_open " << name << " - " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (ftruncate(fd_, MAP_SIZE) < 0) {
+        std::cerr << "ERROR: ftruncate " << name << " - " << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+
+    void* mem = mmap(nullptr, MAP_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mem == MAP_FAILED) {
+        std::cerr << "ERROR: mmap " << name << " - " << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+
+    // Frisches Layout: alter Inhalt (vorheriger Lauf) wird verworfen.
+    // Magic zuletzt, damit ein Producer nie ein halb initialisiertes Segment sieht.
+    header_ = static_cast<Header*>(mem);
+    slots_ = reinterpret_cast<Slot*>(header_ + 1);
+    header_->magic = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->version = VERSION;
+    header_->capacity = CAPACITY;
+    header_->slot_size = SLOT_SIZE;
+    header_->head.store(0);
+    header_->dropped.store(0);
+    header_->tail.store(0);
+    header_->sleeping.store(0);
+    header_->doorbell.store(0);
+    header_->alive.store(1);
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->magic = MAGIC;
+
+    name_ = name;
+    tail_ = 0;
+    std::cout << "✅ MIDI command ring " << name << " (" << CAPACITY << " slots)" << std::endl;
+    return true;
+}
+
+void Consumer::close() {
+    if (header_) {
+        header_->alive.store(0, std::memory_order_release);
+        munmap(header_, MAP_SIZE);
+        header_ = nullptr;
+        slots_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+        shm_unlink(name_);
+    }
+}
+
+const uint8_t* Consumer::peek() {
+    if (tail_ == header_->head.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    return slots_[tail_ & (CAPACITY - 1)].data;
+}
+
+void Consumer::release() {
+    tail_++;
+    header_->tail.store(tail_, std::memory_order_release);
+}
+
+void Consumer::wait(int64_t timeout_ns) {
+    uint32_t bell = header_->doorbell.load(std::memory_order_seq_cst);
+    header_->sleeping.store(1, std::memory_order_seq_cst);
+
+    // Nach sleeping=1 erneut prüfen: ein push() davor hat nicht geweckt
+    if (tail_ == header_->head.load(std::memory_order_seq_cst)) {
+        timespec timeout{static_cast<time_t>(timeout_ns / 1'000'000'000),
+                         static_cast<long>(timeout_ns % 1'000'000'000)};
+        futex(&header_->doorbell, FUTEX_WAIT, bell, &timeout);
+    }
+    header_->sleeping.store(0, std::memory_order_relaxed);
+}
+
+uint32_t Consumer::dropped() const {
+    return header_ ? header_->dropped.load(std::memory_order_relaxed) : 0;
+}
+
+} // namespace command_ring
@@ -0,0 +1,89 @@
+#ifndef COMMAND_RING_HPP
+#define COMMAND_RING_HPP
+
+#include "ipc_protocol.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// ⚡ Shared-Memory Kommando-Ring /tauwerk_midi_commands (Python -> Engine)
+//
+// Heißer Pfad für Fader -> CC ohne Socket: ein Producer (Python über
+// libtauwerk_midi_commands.so), ein Consumer (Output-Thread der Engine).
+// Slots enthalten Records aus ipc_protocol.hpp, nur die RT-sicheren
+// Kommandos (CC, Note, CC14, NRPN/RPN, Param, Automation-Touch) - alles
+// andere über ZMQ.
+//
+// Indizes laufen frei (uint32, Slot = Index & (capacity - 1)). Producer
+// schreibt Slot, dann head (release); Consumer liest head (acquire), dann
+// Slot, dann tail (release). Doorbell: Futex auf doorbell, nur geweckt
+// wenn der Consumer sleeping gesetzt hat - im Normalbetrieb kein Syscall
+// auf Producer-Seite.
+//
+// alive = 1 solange die Engine konsumiert. close() setzt 0 vor shm_unlink:
+// ein Producer, der das alte Segment noch gemappt hat, merkt so den
+// Neustart der Engine und öffnet neu (sonst schreibt er ins Leere).
+namespace command_ring {
+
+constexpr const char* DEFAULT_NAME = "/tauwerk_midi_commands";
+constexpr uint32_t MAGIC = 0x54415557;
+constexpr uint32_t VERSION = 2;
+constexpr uint32_t CAPACITY = 1024;     // Zweierpotenz
+constexpr size_t SLOT_SIZE = 32;        // größter Record (MpeExprRecord) passt
+
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t slot_size;
+    std::atomic<uint32_t> alive;                // Consumer: 0 nach close()
+
+    alignas(64) std::atomic<uint32_t> head;     // Producer
+    std::atomic<uint32_t> dropped;              // Producer: Ring voll
+    alignas(64) std::atomic<uint32_t> tail;     // Consumer
+    std::atomic<uint32_t> sleeping;             // Consumer wartet im Futex
+    std::atomic<uint32_t> doorbell;             // Futex-Wort
+};
+
+struct Slot {
+    uint8_t data[SLOT_SIZE];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "Futex braucht lock-freie 32-bit Atomics");
+static_assert(sizeof(std::atomic<uint32_t>) == 4, "Ring Layout");
+static_assert(sizeof(Header) == 192, "Ring Layout");
+
+constexpr size_t MAP_SIZE = sizeof(Header) + CAPACITY * sizeof(Slot);
+
+// Producer-Seite (ein Thread). false = Ring voll (dropped wird gezählt)
+bool push(Header* header, Slot* slots, const void* record, size_t size);
+
+// Consumer-Seite
+class Consumer {
+public:
+    Consumer();
+    ~Consumer();
+
+    bool create(const char* name = DEFAULT_NAME);   // legt das Segment an
+    void close();
+    bool attached() const { return header_ != nullptr; }
+
+    // Nächsten Record holen (nullptr = leer). Gültig bis release().
+    const uint8_t* peek();
+    void release();
+
+    // Schlafen bis Doorbell oder Timeout
+    void wait(int64_t timeout_ns);
+    uint32_t dropped() const;
+
+private:
+    Header* header_;
+    Slot* slots_;
+    int fd_;
+    const char* name_;
+    uint32_t tail_;         // lokale Kopie, nur release() publiziert
+};
+
+} // namespace command_ring
+
+#endif
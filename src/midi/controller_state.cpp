@@ -0,0 +1,94 @@
+#include "controller_state.hpp"
+
+namespace {
+
+constexpr uint8_t CC_DATA_ENTRY = 6;
+constexpr uint8_t CC_DATA_ENTRY_LSB = 38;
+constexpr uint8_t CC_DATA_INCREMENT = 96;
+constexpr uint8_t CC_DATA_DECREMENT = 97;
+constexpr uint8_t CC_NRPN_LSB = 98;
+constexpr uint8_t CC_NRPN_MSB = 99;
+constexpr uint8_t CC_RPN_LSB = 100;
+constexpr uint8_t CC_RPN_MSB = 101;
+constexpr uint8_t CC_RESET_ALL = 121;
+
+} // namespace
+
+ControllerState::ControllerState() {
+    reset();
+}
+
+void ControllerState::reset() {
+    for (int ch = 0; ch < 16; ch++) {
+        resetChannel(ch);
+    }
+}
+
+void ControllerState::resetChannel(int ch) {
+    for (int cc = 0; cc < 128; cc++) {
+        value_[ch][cc] = -1;
+    }
+    address_[ch] = ADDRESS_NONE;
+}
+
+bool ControllerState::filter(const MidiMessage& msg, const MidiMessage* next) {
+    if (msg.type() == MidiMessage::TYPE_MIDI2) {
+        // MIDI 2.0 CC/(N)RPN: Übersetzung für MIDI-1.0 Empfänger macht der Port -> Kanal unbekannt
+        uint8_t opcode = msg.status() & 0xF0;
+        if (opcode == 0xB0 || (opcode >= 0x20 && opcode <= 0x50)) {
+            resetChannel(msg.status() & 0x0F);
+        }
+        return true;
+    }
+    if (msg.type() != MidiMessage::TYPE_MIDI1 || (msg.status() & 0xF0) != 0xB0) return true;
+
+    const uint8_t ch = msg.status() & 0x0F;
+    const uint8_t cc = msg.data1() & 0x7F;
+    const int16_t value = msg.data2() & 0x7F;
+    int16_t* values = value_[ch];
+
+    switch (cc) {
+        case CC_NRPN_MSB:
+        case CC_NRPN_LSB:
+        case CC_RPN_MSB:
+        case CC_RPN_LSB: {
+            Address kind = cc >= CC_RPN_LSB ? ADDRESS_RPN : ADDRESS_NRPN;
+            if (address_[ch] != kind) {
+                // Wechsel NRPN <-> RPN: nicht auf alte Register verlassen
+                uint8_t lsb = kind == ADDRESS_RPN ? CC_RPN_LSB : CC_NRPN_LSB;
+                values[lsb] = -1;
+                values[lsb + 1] = -1;
+                address_[ch] = kind;
+            } else if (values[cc] == value) {
+                return false;
+            }
+            values[cc] = value;
+            // Neuer Parameter: Data-Entry-Stand des Empfängers unbekannt
+            values[CC_DATA_ENTRY] = -1;
+            values[CC_DATA_ENTRY_LSB] = -1;
+            return true;
+        }
+        case CC_DATA_INCREMENT:
+        case CC_DATA_DECREMENT:
+            values[CC_DATA_ENTRY] = -1;
+            values[CC_DATA_ENTRY_LSB] = -1;
+            return true;
+        case CC_RESET_ALL:
+            // RP-015: setzt auch die Parameter-Adresse zurück
+            for (int i = 0; i < 120; i++) {
+                values[i] = -1;
+            }
+            address_[ch] = ADDRESS_NONE;
+            return true;
+        default:
+            break;
+    }
+
+    // MSB nur, wenn es sich geändert hat und das LSB sicher folgt
+    if (cc < 32 && values[cc] == value && next &&
+        next->words[0] >> 16 == msg.words[0] >> 16 && next->data1() == cc + 32) {
+        return false;
+    }
+    values[cc] = value;
+    return true;
+}
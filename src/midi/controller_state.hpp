@@ -0,0 +1,34 @@
+#ifndef CONTROLLER_STATE_HPP
+#define CONTROLLER_STATE_HPP
+
+#include "midi_message.hpp"
+#include <cstdint>
+
+// 🎛 Controller-Zustand auf dem Draht (ein Ausgangsport)
+//
+// Gehört dem Output-Thread und sieht jede gesendete Message, egal aus welcher
+// Queue - der Cache kann also nicht veralten. Verworfen wird nur, was den
+// Empfänger-Zustand garantiert nicht ändert:
+//   - NRPN/RPN-Adresse (99/98, 101/100), die schon aktiv ist
+//   - MSB eines 14-bit Paares (0..31, auch Data Entry 6), wenn der Wert gleich ist
+//     und das zugehörige LSB direkt dahinter in derselben Queue liegt
+// Einzelne 7-bit CCs gehen immer raus. MIDI 2.0 CCs/(N)RPNs verwerfen den
+// Zustand des Kanals.
+class ControllerState {
+public:
+    ControllerState();
+
+    // true = senden. next: nächste Message derselben Queue (oder nullptr)
+    bool filter(const MidiMessage& msg, const MidiMessage* next);
+    void reset();
+
+private:
+    void resetChannel(int ch);
+
+    enum Address : uint8_t { ADDRESS_NONE, ADDRESS_NRPN, ADDRESS_RPN };
+
+    int16_t value_[16][128];    // zuletzt gesendeter Wert, -1 = unbekannt
+    Address address_[16];       // zuletzt gewählter Parametertyp
+};
+
+#endif
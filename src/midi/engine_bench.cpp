@@ -0,0 +1,537 @@
+// engine_bench.cpp - Benchmark für LockFreeEngine
+//
+// Voraussetzung (Loopback ohne Hardware):
+//   sudo modprobe snd-seq-dummy ports=2
+//
+// Topologie:
+//   Engine OUT  -> Midi Through:0 -> Bench IN
+//   Bench  OUT  -> Midi Through:1 -> Engine IN (Thru zurück nach Through:0)
+//
+// Aufruf:
+//   bin/tauwerk_midi_bench [--through 14] [--seconds 5] [--json out.json] [--offline]
+//
+// Mit make bench RT_CHECK=1 werden RT-Verstöße der Engine-Threads mitgezählt
+// (siehe rt_check.hpp) und im JSON unter "rt_violations" ausgegeben.
+//
+// Ergebnis ist JSON (stdout oder --json), damit Commits auf derselben Maschine
+// vergleichbar sind. Exit-Code 1, wenn die Clock über 24 h virtuelle Zeit driftet.
+
+#include "ipc_protocol.hpp"
+#include "lockfree_engine.hpp"
+#include "rt_check.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <unistd.h>
+
+#ifndef TAUWERK_GIT_REV
+#define TAUWERK_GIT_REV "unknown"
+#endif
+
+namespace {
+
+int64_t monotonicNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+}
+
+struct Summary {
+    double mean = 0;
+    double stddev = 0;
+    double p50 = 0;
+    double p99 = 0;
+    double max = 0;
+    size_t count = 0;
+};
+
+Summary summarize(std::vector<double> values) {
+    Summary s;
+    s.count = values.size();
+    if (values.empty()) return s;
+
+    std::sort(values.begin(), values.end());
+    double sum = 0;
+    for (double v : values) sum += v;
+    s.mean = sum / values.size();
+
+    double var = 0;
+    for (double v : values) var += (v - s.mean) * (v - s.mean);
+    s.stddev = std::sqrt(var / values.size());
+
+    s.p50 = values[values.size() / 2];
+    s.p99 = values[std::min(values.size() - 1, values.size() * 99 / 100)];
+    s.max = values.back();
+    return s;
+}
+
+void writeSummary(FILE* out, const char* name, const Summary& s, const char* unit, bool last = false) {
+    fprintf(out, "    \"%s\": {\"unit\": \"%s\", \"count\": %zu, \"mean\": %.3f, \"stddev\": %.3f, "
+                 "\"p50\": %.3f, \"p99\": %.3f, \"max\": %.3f}%s\n",
+            name, unit, s.count, s.mean, s.stddev, s.p50, s.p99, s.max, last ? "" : ",");
+}
+
+// 📏 Mess-Client: eigener ALSA Client mit einem Duplex-Port
+class MeasurementClient {
+public:
+    ~MeasurementClient() {
+        stopReceiver();
+        if (seq_) snd_seq_close(seq_);
+    }
+
+    bool open(int through_client) {
+        if (snd_seq_open(&seq_, "default", SND_SEQ_OPEN_DUPLEX, 0) < 0) {
+            return false;
+        }
+        snd_seq_set_client_name(seq_, "Tauwerk_Bench");
+        port_ = snd_seq_create_simple_port(seq_, "Bench",
+            SND_SEQ_PORT_CAP_READ | SND_SEQ_PORT_CAP_WRITE |
+            SND_SEQ_PORT_CAP_SUBS_READ | SND_SEQ_PORT_CAP_SUBS_WRITE,
+            SND_SEQ_PORT_TYPE_MIDI_GENERIC | SND_SEQ_PORT_TYPE_APPLICATION);
+
+        if (snd_seq_connect_from(seq_, port_, through_client, 0) < 0 ||
+            snd_seq_connect_to(seq_, port_, through_client, 1) < 0) {
+            return false;
+        }
+        return true;
+    }
+
+    void startReceiver() {
+        receiving_.store(true);
+        receiver_ = std::thread(&MeasurementClient::receiveLoop, this);
+    }
+
+    void stopReceiver() {
+        if (receiving_.exchange(false) && receiver_.joinable()) {
+            receiver_.join();
+        }
+    }
+
+    void sendNote(int channel, int note, int velocity) {
+        snd_seq_event_t ev;
+        snd_seq_ev_clear(&ev);
+        snd_seq_ev_set_noteon(&ev, channel, note, velocity);
+        snd_seq_ev_set_source(&ev, port_);
+        snd_seq_ev_set_subs(&ev);
+        snd_seq_ev_set_direct(&ev);
+        snd_seq_event_output_direct(seq_, &ev);
+    }
+
+    // Vom Receiver-Thread befüllt
+    std::atomic<int64_t> clock_count{0};
+    std::atomic<int64_t> cc_count{0};
+    std::atomic<int64_t> last_note_ns{0};
+    std::atomic<int> last_note{-1};
+    std::vector<int64_t> clock_times;
+
+private:
+    void receiveLoop() {
+        int npfd = snd_seq_poll_descriptors_count(seq_, POLLIN);
+        std::vector<pollfd> pfds(npfd);
+        snd_seq_poll_descriptors(seq_, pfds.data(), npfd, POLLIN);
+
+        while (receiving_.load()) {
+            if (poll(pfds.data(), npfd, 10) <= 0) continue;
+
+            snd_seq_event_t* ev = nullptr;
+            while (snd_seq_event_input(seq_, &ev) > 0) {
+                if (!ev) continue;
+                int64_t now = monotonicNs();
+
+                switch (ev->type) {
+                    case SND_SEQ_EVENT_CLOCK:
+                        if (clock_times.size() < clock_times.capacity()) {
+                            clock_times.push_back(now);
+                        }
+                        clock_count.fetch_add(1);
+                        break;
+                    case SND_SEQ_EVENT_CONTROLLER:
+                        cc_count.fetch_add(1);
+                        break;
+                    case SND_SEQ_EVENT_NOTEON:
+                        last_note_ns.store(now);
+                        last_note.store(ev->data.note.note);
+                        break;
+                }
+                snd_seq_free_event(ev);
+            }
+        }
+    }
+
+    snd_seq_t* seq_ = nullptr;
+    int port_ = -1;
+    std::atomic<bool> receiving_{false};
+    std::thread receiver_;
+};
+
+// ⏱ Clock-Jitter: Abweichung der empfangenen Tick-Abstände vom Soll (µs)
+Summary benchClockJitter(LockFreeEngine& engine, MeasurementClient& client, double bpm, int seconds) {
+    const double expected_ns = 60e9 / (bpm * 24);
+    client.clock_times.clear();
+    client.clock_times.reserve(static_cast<size_t>(seconds * 1e9 / expected_ns) + 64);
+
+    engine.setClockMode(1);
+    engine.setBpm(bpm);
+    engine.startClock();
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    engine.stopClock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    std::vector<double> jitter_us;
+    const auto& t = client.clock_times;
+    for (size_t i = 1; i < t.size(); i++) {
+        jitter_us.push_back(std::fabs((t[i] - t[i - 1]) - expected_ns) / 1000.0);
+    }
+    return summarize(jitter_us);
+}
+
+// 🚀 CC-Durchsatz: so schnell wie möglich senden, empfangene CCs/s zählen
+struct ThroughputResult {
+    int64_t attempted = 0;
+    int64_t overflowed = 0;
+    int64_t received = 0;
+    double seconds = 0;
+};
+
+ThroughputResult benchCcThroughput(LockFreeEngine& engine, MeasurementClient& client, int seconds) {
+    ThroughputResult r;
+    int64_t overflow_before = engine.getStats().out_queue_overflows;
+    int64_t received_before = client.cc_count.load();
+
+    int64_t start = monotonicNs();
+    int64_t end = start + static_cast<int64_t>(seconds) * 1'000'000'000;
+    while (monotonicNs() < end) {
+        for (int i = 0; i < 128; i++) {
+            engine.sendMidiCC(0, 1, i);
+        }
+        r.attempted += 128;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    r.seconds = (monotonicNs() - start) / 1e9;
+    r.overflowed = engine.getStats().out_queue_overflows - overflow_before;
+    r.received = client.cc_count.load() - received_before;
+    return r;
+}
+
+// 🔁 Note-In -> Note-Out Latenz über die Thru-Route (Ping-Pong, µs)
+Summary benchThruLatency(LockFreeEngine& engine, MeasurementClient& client, int rounds) {
+    engine.setThru(true);
+    std::vector<double> latency_us;
+    latency_us.reserve(rounds);
+
+    for (int i = 0; i < rounds; i++) {
+        int note = i % 128;
+        client.last_note.store(-1);
+        int64_t sent = monotonicNs();
+        client.sendNote(0, note, 100);
+
+        // Max. 100ms auf Rückkehr warten
+        while (client.last_note.load() != note && monotonicNs() - sent < 100'000'000) {
+            std::this_thread::yield();
+        }
+        if (client.last_note.load() == note) {
+            latency_us.push_back((client.last_note_ns.load() - sent) / 1000.0);
+        }
+    }
+
+    engine.setThru(false);
+    return summarize(latency_us);
+}
+
+// 📦 Overflow-Schwelle: kleinste Burst-Größe, bei der midi_out_queue_ überläuft
+int64_t benchOverflowThreshold(LockFreeEngine& engine) {
+    for (int64_t burst = 64; burst <= 65536; burst *= 2) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50)); // Queue leerlaufen lassen
+        int64_t before = engine.getStats().out_queue_overflows;
+        for (int64_t i = 0; i < burst; i++) {
+            engine.sendMidiCC(1, 7, static_cast<int>(i & 0x7F));
+        }
+        if (engine.getStats().out_queue_overflows > before) {
+            return burst;
+        }
+    }
+    return -1;
+}
+
+// 🧪 Offline: Clock-Render mit virtueller Zeit (ohne ALSA)
+struct OfflineResult {
+    int64_t ticks = 0;
+    double wall_ms = 0;
+    uint64_t hash = 0;
+};
+
+OfflineResult benchOfflineRender(double bpm, int64_t virtual_seconds) {
+    OfflineResult r;
+    VirtualTimeSource time_source;
+    MemorySink sink(static_cast<size_t>(virtual_seconds * bpm * 24 / 60) + 64);
+
+    LockFreeEngine engine;
+    engine.setTimeSource(&time_source);
+    engine.setSink(&sink);
+    engine.setBpm(bpm);
+    engine.setClockMode(1);
+    engine.startClock();
+
+    int64_t start = monotonicNs();
+    r.ticks = engine.renderOffline(virtual_seconds * 1'000'000'000);
+    r.wall_ms = (monotonicNs() - start) / 1e6;
+    r.hash = sink.hash();
+    return r;
+}
+
+// 🧪 LFO: Konfiguration über dieselben IPC-Records wie app/midi.py, dann Offline-Render.
+// Zählt die erzeugten CCs und hasht den Output (Regressionen in modulation.cpp).
+struct LfoResult {
+    int64_t cc = 0;
+    int64_t cc_after_clear = 0;
+    uint64_t dropped = 0;
+    uint64_t hash = 0;
+};
+
+LfoResult benchLfoRender(double bpm, int64_t virtual_seconds) {
+    LfoResult r;
+    VirtualTimeSource time_source;
+    // Clock-Ticks + höchstens ein CC pro LFO und Control-Tick (500 Hz)
+    MemorySink sink(static_cast<size_t>(virtual_seconds * (bpm * 24 / 60 + 2 * 500)) + 64);
+
+    LockFreeEngine engine;
+    engine.setTimeSource(&time_source);
+    engine.setSink(&sink);
+    engine.setBpm(bpm);
+    engine.setClockMode(1);
+    engine.startClock();
+
+    // Frei laufender Sinus auf CC 74 und tempo-synchroner Saw auf CC 71
+    ipc::LfoRecord lfo[2] = {};
+    for (auto& record : lfo) {
+        record.header = ipc::Header{ipc::VERSION, ipc::CMD_LFO, sizeof(ipc::LfoRecord)};
+        record.target = static_cast<uint8_t>(ModTarget::CC);
+        record.depth = 1.0f;
+        record.center = 0.5f;
+    }
+    lfo[0].index = 0;
+    lfo[0].shape = static_cast<uint8_t>(LfoShape::SINE);
+    lfo[0].controller = 74;
+    lfo[0].rate = 0.5f;
+    lfo[1].index = 1;
+    lfo[1].shape = static_cast<uint8_t>(LfoShape::SAW);
+    lfo[1].controller = 71;
+    lfo[1].tempo_sync = 1;
+    lfo[1].rate = 0.25f;
+    if (ipc::dispatchBinary(engine, reinterpret_cast<const uint8_t*>(lfo), sizeof(lfo)) != 2) {
+        std::cerr << "ERROR: LFO records rejected" << std::endl;
+        return r;
+    }
+
+    auto countCc = [&sink]() {
+        int64_t n = 0;
+        for (const auto& msg : sink.events()) {
+            if ((msg.status() & 0xF0) == 0xB0) n++;
+        }
+        return n;
+    };
+
+    engine.renderOffline(virtual_seconds * 1'000'000'000);
+    r.cc = countCc();
+    r.dropped = sink.dropped();
+    r.hash = sink.hash();
+
+    ipc::ByteRecord clear[2] = {};
+    for (int i = 0; i < 2; i++) {
+        clear[i].header = ipc::Header{ipc::VERSION, ipc::CMD_LFO_CLEAR, sizeof(ipc::ByteRecord)};
+        clear[i].value0 = static_cast<uint8_t>(i);
+    }
+    ipc::dispatchBinary(engine, reinterpret_cast<const uint8_t*>(clear), sizeof(clear));
+    sink.clear();
+    engine.renderOffline(1'000'000'000);
+    r.cc_after_clear = countCc();
+    return r;
+}
+
+// 🧪 Drift: jeder Clock-Tick gegen die exakte Soll-Zeit start + n * 60e9 / (24 * bpm),
+// ganzzahlig gerechnet. Prüft on-the-fly statt alle Ticks zu speichern.
+class DriftSink : public MidiSink {
+public:
+    explicit DriftSink(double bpm) : micro_bpm_(std::llround(bpm * 1e6)) {}
+
+    void write(const MidiMessage& msg) override {
+        if (msg.status() != 0xF8) return;
+        if (ticks_ == 0) start_ = msg.timestamp;
+        __int128 exact = (__int128(ticks_) * 2'500'000'000'000'000 + micro_bpm_ / 2) / micro_bpm_;
+        int64_t error = msg.timestamp - start_ - static_cast<int64_t>(exact);
+        max_error_ns = std::max(max_error_ns, std::abs(error));
+        end_error_ns = error;
+        ticks_++;
+    }
+
+    int64_t ticks() const { return ticks_; }
+
+    int64_t max_error_ns = 0;
+    int64_t end_error_ns = 0;
+
+private:
+    int64_t micro_bpm_;
+    int64_t ticks_ = 0;
+    int64_t start_ = 0;
+};
+
+struct DriftResult {
+    double bpm = 0;
+    int64_t ticks = 0;
+    int64_t max_error_ns = 0;
+    int64_t end_error_ns = 0;
+    int64_t truncated_drift_ns = 0;   // Zum Vergleich: aufaddiertes abgeschnittenes Intervall
+};
+
+DriftResult benchDrift(double bpm, int64_t virtual_seconds) {
+    VirtualTimeSource time_source;
+    DriftSink sink(bpm);
+
+    LockFreeEngine engine;
+    engine.setTimeSource(&time_source);
+    engine.setSink(&sink);
+    engine.setBpm(bpm);
+    engine.setClockMode(1);
+    engine.startClock();
+    engine.renderOffline(virtual_seconds * 1'000'000'000);
+
+    DriftResult r;
+    r.bpm = bpm;
+    r.ticks = sink.ticks();
+    r.max_error_ns = sink.max_error_ns;
+    r.end_error_ns = sink.end_error_ns;
+    double exact_interval = 60e9 / (bpm * 24);
+    r.truncated_drift_ns = std::llround((r.ticks - 1) * (exact_interval - static_cast<int64_t>(exact_interval)));
+    return r;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int through_client = 14;
+    int seconds = 5;
+    bool offline_only = false;
+    const char* json_path = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--through") && i + 1 < argc) through_client = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--json") && i + 1 < argc) json_path = argv[++i];
+        else if (!strcmp(argv[i], "--offline")) offline_only = true;
+    }
+
+    OfflineResult offline = benchOfflineRender(120.0, 3600);
+    // 24 h bei 133 BPM: Intervall 18796992.48 ns, also nicht ganzzahlig
+    DriftResult drift = benchDrift(133.0, 86400);
+    LfoResult lfo = benchLfoRender(120.0, 60);
+
+    Summary jitter, latency;
+    ThroughputResult throughput;
+    int64_t overflow_burst = -1;
+    bool loopback = false;
+    bool ump = false;
+
+    if (!offline_only) {
+        LockFreeEngine engine;
+        MeasurementClient client;
+        char through_out[16], through_in[16];
+        snprintf(through_out, sizeof(through_out), "%d:0", through_client);
+        snprintf(through_in, sizeof(through_in), "%d:1", through_client);
+
+        loopback = engine.initialize() &&
+                   engine.connectOutput(through_out) &&
+                   engine.connectInput(through_in) &&
+                   client.open(through_client);
+
+        if (loopback) {
+            ump = engine.umpActive();
+            engine.start();
+            client.startReceiver();
+
+            jitter = benchClockJitter(engine, client, 120.0, seconds);
+            throughput = benchCcThroughput(engine, client, seconds);
+            latency = benchThruLatency(engine, client, 1000);
+            overflow_burst = benchOverflowThreshold(engine);
+
+            client.stopReceiver();
+            engine.stop();
+        } else {
+            std::cerr << "WARNING: snd-seq-dummy loopback not available (modprobe snd-seq-dummy ports=2)" << std::endl;
+        }
+    }
+
+    FILE* out = json_path ? fopen(json_path, "w") : stdout;
+    if (!out) {
+        std::cerr << "ERROR: Cannot write " << json_path << std::endl;
+        return 1;
+    }
+
+    char host[64] = {0};
+    gethostname(host, sizeof(host) - 1);
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"git_rev\": \"%s\",\n", TAUWERK_GIT_REV);
+    fprintf(out, "  \"host\": \"%s\",\n", host);
+    fprintf(out, "  \"timestamp\": %ld,\n", static_cast<long>(time(nullptr)));
+    fprintf(out, "  \"offline_render\": {\"virtual_seconds\": 3600, \"ticks\": %ld, \"wall_ms\": %.3f, "
+                 "\"ticks_per_sec\": %.0f, \"hash\": \"%016llx\"},\n",
+            static_cast<long>(offline.ticks), offline.wall_ms,
+            offline.wall_ms > 0 ? offline.ticks / (offline.wall_ms / 1000.0) : 0.0,
+            static_cast<unsigned long long>(offline.hash));
+    fprintf(out, "  \"clock_drift\": {\"virtual_seconds\": 86400, \"bpm\": %.1f, \"ticks\": %ld, "
+                 "\"max_error_ns\": %ld, \"end_error_ns\": %ld, \"truncated_drift_ns\": %ld},\n",
+            drift.bpm, static_cast<long>(drift.ticks), static_cast<long>(drift.max_error_ns),
+            static_cast<long>(drift.end_error_ns), static_cast<long>(drift.truncated_drift_ns));
+    fprintf(out, "  \"lfo_render\": {\"virtual_seconds\": 60, \"cc\": %ld, \"cc_after_clear\": %ld, "
+                 "\"hash\": \"%016llx\"},\n",
+            static_cast<long>(lfo.cc), static_cast<long>(lfo.cc_after_clear),
+            static_cast<unsigned long long>(lfo.hash));
+    if (rt_check::enabled()) {
+        rt_check::printSummary();
+        fprintf(out, "  \"rt_violations\": {\"malloc\": %ld, \"free\": %ld, \"mutex\": %ld, \"syscall\": %ld},\n",
+                static_cast<long>(rt_check::count(rt_check::ALLOC)),
+                static_cast<long>(rt_check::count(rt_check::FREE)),
+                static_cast<long>(rt_check::count(rt_check::MUTEX)),
+                static_cast<long>(rt_check::count(rt_check::SYSCALL)));
+    }
+    fprintf(out, "  \"loopback\": %s,\n", loopback ? "true" : "false");
+    fprintf(out, "  \"ump\": %s", ump ? "true" : "false");
+
+    if (loopback) {
+        fprintf(out, ",\n  \"results\": {\n");
+        writeSummary(out, "clock_jitter", jitter, "us");
+        writeSummary(out, "thru_latency", latency, "us");
+        fprintf(out, "    \"cc_throughput\": {\"attempted\": %ld, \"overflowed\": %ld, \"received\": %ld, "
+                     "\"received_per_sec\": %.0f},\n",
+                static_cast<long>(throughput.attempted), static_cast<long>(throughput.overflowed),
+                static_cast<long>(throughput.received),
+                throughput.seconds > 0 ? throughput.received / throughput.seconds : 0.0);
+        fprintf(out, "    \"out_queue_overflow_burst\": %ld\n", static_cast<long>(overflow_burst));
+        fprintf(out, "  }\n}\n");
+    } else {
+        fprintf(out, "\n}\n");
+    }
+
+    if (out != stdout) fclose(out);
+
+    if (lfo.cc == 0 || lfo.dropped > 0 || lfo.cc_after_clear != 0) {
+        std::cerr << "ERROR: LFO render produced " << lfo.cc << " CCs, " << lfo.cc_after_clear
+                  << " after clear" << std::endl;
+        return 1;
+    }
+
+    // Mehr als Rundung auf ganze ns = Drift
+    if (drift.max_error_ns > 1) {
+        std::cerr << "ERROR: Clock drift " << drift.max_error_ns << " ns after 24 h" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,167 @@
+// ipc_bench.cpp - Parse-/Dispatch-Kosten des IPC-Protokolls: JSON vs. Binär
+//
+// Aufruf:
+//   bin/tauwerk_ipc_bench [--count 200000] [--json out.json]
+//
+// Misst pro CC-Kommando Zeit und Heap-Allokationen von Frame bis Engine-Queue.
+// Die Engine läuft nicht (kein ALSA), die Queue wird außerhalb der Messung
+// über einen MemorySink geleert. std::cout ist während der Messung stumm,
+// damit die Log-Zeilen des JSON-Pfads nicht das Terminal mitmessen.
+
+#include "ipc_protocol.hpp"
+#include "lockfree_engine.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifndef TAUWERK_GIT_REV
+#define TAUWERK_GIT_REV "unknown"
+#endif
+
+namespace {
+
+std::atomic<int64_t> g_allocations{0};
+
+int64_t monotonicNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+}
+
+struct Result {
+    double ns_per_msg = 0;
+    double allocs_per_msg = 0;
+    int64_t overflows = 0;   // muss 0 sein, sonst misst der Lauf verworfene Pushes
+};
+
+constexpr int DRAIN_EVERY = 512;  // Messages zwischen zwei Drains, < Queue-Größe
+
+// frames_per_drain * Messages pro Frame darf DRAIN_EVERY nicht übersteigen
+template <typename Dispatch>
+Result measure(LockFreeEngine& engine, int count, int frames_per_drain, Dispatch dispatch) {
+    Result r;
+    int64_t elapsed = 0;
+    int64_t allocations = 0;
+    const int64_t overflows_before = engine.getStats().out_queue_overflows;
+
+    std::cout.setstate(std::ios::failbit);
+    for (int done = 0; done < count; done += frames_per_drain) {
+        int n = std::min(frames_per_drain, count - done);
+
+        int64_t alloc_before = g_allocations.load();
+        int64_t start = monotonicNs();
+        for (int i = 0; i < n; i++) {
+            dispatch(done + i);
+        }
+        elapsed += monotonicNs() - start;
+        allocations += g_allocations.load() - alloc_before;
+
+        engine.renderOffline(0);
+    }
+    std::cout.clear();
+
+    r.ns_per_msg = static_cast<double>(elapsed) / count;
+    r.allocs_per_msg = static_cast<double>(allocations) / count;
+    r.overflows = engine.getStats().out_queue_overflows - overflows_before;
+    return r;
+}
+
+ipc::CcRecord ccRecord(int i) {
+    ipc::CcRecord r{};
+    r.header = ipc::Header{ipc::VERSION, ipc::CMD_CC, sizeof(ipc::CcRecord)};
+    r.channel = 0;
+    r.controller = 7;
+    r.value = static_cast<uint8_t>(i & 0x7F);
+    return r;
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+int main(int argc, char** argv) {
+    int count = 200000;
+    const char* json_path = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--count") && i + 1 < argc) count = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--json") && i + 1 < argc) json_path = argv[++i];
+    }
+
+    MemorySink sink(DRAIN_EVERY * 16);
+    LockFreeEngine engine;
+    engine.setSink(&sink);
+
+    // Frames vorab bauen - gemessen wird nur Parse + Dispatch
+    std::vector<std::string> json_frames(128);
+    for (int i = 0; i < 128; i++) {
+        json_frames[i] = "{\"type\": \"cc\", \"channel\": 0, \"controller\": 7, \"value\": " + std::to_string(i) + "}";
+    }
+
+    constexpr int BATCH = 16;
+    std::vector<uint8_t> batch_frame(BATCH * sizeof(ipc::CcRecord));
+    for (int i = 0; i < BATCH; i++) {
+        ipc::CcRecord r = ccRecord(i);
+        std::memcpy(&batch_frame[i * sizeof(r)], &r, sizeof(r));
+    }
+
+    Result json = measure(engine, count, DRAIN_EVERY, [&](int i) {
+        ipc::dispatchJson(engine, json_frames[i & 127]);
+    });
+
+    Result binary = measure(engine, count, DRAIN_EVERY, [&](int i) {
+        ipc::CcRecord r = ccRecord(i);
+        ipc::dispatchBinary(engine, reinterpret_cast<const uint8_t*>(&r), sizeof(r));
+    });
+
+    Result batched = measure(engine, count / BATCH, DRAIN_EVERY / BATCH, [&](int) {
+        ipc::dispatchBinary(engine, batch_frame.data(), batch_frame.size());
+    });
+    batched.ns_per_msg /= BATCH;
+    batched.allocs_per_msg /= BATCH;
+
+    FILE* out = json_path ? fopen(json_path, "w") : stdout;
+    if (!out) {
+        std::cerr << "ERROR: Cannot write " << json_path << std::endl;
+        return 1;
+    }
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"git_rev\": \"%s\",\n", TAUWERK_GIT_REV);
+    fprintf(out, "  \"messages\": %d,\n", count);
+    fprintf(out, "  \"json\": {\"ns_per_msg\": %.1f, \"allocs_per_msg\": %.2f},\n",
+            json.ns_per_msg, json.allocs_per_msg);
+    fprintf(out, "  \"binary\": {\"ns_per_msg\": %.1f, \"allocs_per_msg\": %.2f},\n",
+            binary.ns_per_msg, binary.allocs_per_msg);
+    fprintf(out, "  \"binary_batch%d\": {\"ns_per_msg\": %.1f, \"allocs_per_msg\": %.2f}\n",
+            BATCH, batched.ns_per_msg, batched.allocs_per_msg);
+    fprintf(out, "}\n");
+
+    if (out != stdout) fclose(out);
+
+    // Überlauf der Engine-Queue: die Zahlen oben messen dann verworfene Pushes
+    const int64_t overflows = json.overflows + binary.overflows + batched.overflows;
+    if (overflows > 0) {
+        std::cerr << "ERROR: " << overflows << " out queue overflows during measurement" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,412 @@
+#include "ipc_protocol.hpp"
+#include "lockfree_engine.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <json/json.h>
+
+namespace ipc {
+
+namespace {
+
+// Record per memcpy lesen: keine Alignment-Annahmen über den ZMQ-Buffer
+template <typename Record>
+Record load(const uint8_t* data) {
+    Record record;
+    std::memcpy(&record, data, sizeof(Record));
+    return record;
+}
+
+void onCc(LockFreeEngine& engine, const uint8_t* data, size_t) {
+    auto r = load<CcRecord>(data);
+    engine.sendMidiCC(r.channel & 0x0F, r.controller & 0x7F, r.value & 0x7F);
+}
+
+void onNote(LockFreeEngine& engine, const uint8_t* data, size_t) {
+    auto r = load<NoteRecord>(data);
+    engine.sendMidiNote(r.channel & 0x0F, r.note & 0x7F, r.velocity & 0x7F);
+}
+
+void onBpm(LockFreeEngine& engine, const uint8_t* data, size_t) {
+    engine.setBpm(load<BpmRecord>(data).bpm);
+}
+
+void onBpmRamp(LockFreeEngine& engine, const uint8_t* data, size_t) {
+    auto r = load<BpmRampRecord>(data);
+    engine.rampBpm(r.bpm, r.ticks);
+}
+
+void onClockMode(LockFreeEngine& engine, const uint8_t* data, size_t) {
+    engine.setClockMode(load<ByteRecord>(data).value0);
+}
+
+void onClockStart(LockFreeEngine& engine, const uint8_t*, size_t) {
+    engine.startClock();
+}
+
+void onClockStop(LockFreeEngine& engine, const uint8_t*, size_t) {
+    engine.stopClock();
+}
+
+void onParam(LockFreeEngine& engine, const uint8_t* data, size_t) {
+    auto r = load<ParamRecord>(data);
+    engine.setParameter(r.param, r.value);
+}
+
+void onLearn(LockFreeEngine& engine, const uint8_t* data, size_t) {
+    auto r = load<LearnRecord>(data);
+    engine.armLearn(r.param, r.min / 255.0f, r.max / 255.0f, r.pickup != 0);
+}
+
+void onLearnCancel(LockFreeEngine& engine, const uint8_t*, size_t) {
+    engine.cancelLearn();
+}
+
+void onMpeConfig(LockFreeEngine& engine, const uint8_t* data, size_t) {
+    auto r = load<MpeConfigRecord>(data);
+    engine.mpeConfigure(r.channels, r.bend_range);
+}
+
+void onMpeOn(LockFreeEngine& engine, const uint8_t* data, size_t) {
+    auto r = load<MpeOnRecord>(data);
+    engine.mpeNoteOn(r.voice, r.note, r.velocity, r.bend, r.timbre);
+}
+
+void onMpeExpr(LockFreeEngine& engine, const uint8_t* data, size_t) {
+    auto r = load<MpeExprRecord>(data);
+    engine.mpeExpression(r.voice, r.bend, r.pressure, r.timbre);
+}
+
+void onMpeOff(LockFreeEngine& engine, const uint8_t* data, size_t) {
+    auto r = load<ByteRecord>(data);
+    engine.mpeNoteOff(r.value0, r.value1);
+}
+
+void onCc14(LockFreeEngine& engine, const uint8_t* data, size_t) {
+    auto r = load<Cc14Record>(data);
+    engine.sendMidiCC14(r.channel & 0x0F, r.controller, r.value);
+}
+
+void onNrpn(LockFreeEngine& engine, const uint8_t* data, size_t) {
+    auto r = load<ParameterRecord>(data);
+    engine.sendNrpn(r.channel & 0x0F, r.parameter, r.value, r.hires != 0);
+}
+
+void onRpn(LockFreeEngine& engine, const uint8_t* data, size_t) {
+    auto r = load<ParameterRecord>(data);
+    engine.sendRpn(r.channel & 0x0F, r.parameter, r.value, r.hires != 0);
+}
+
+// Editor-Kommandos mit variabler Länge - hier darf alloziert werden
+void onMorphTargets(LockFreeEngine& engine, const uint8_t* data, size_t size) {
+    auto r = load<MorphTargetsRecord>(data);
+    if (sizeof(r) + r.count * 4u > size) return;
+
+    std::vector<MorphTarget> targets(r.count);
+    const uint8_t* entry = data + sizeof(r);
+    for (uint16_t i = 0; i < r.count; i++, entry += 4) {
+        targets[i] = MorphTarget{entry[0], entry[1], entry[2] != 0};
+    }
+    engine.setMorphTargets(std::move(targets));
+}
+
+void onMorphSnapshot(LockFreeEngine& engine, const uint8_t* data, size_t size) {
+    auto r = load<MorphSnapshotRecord>(data);
+    if (sizeof(r) + r.count * sizeof(float) > size) return;
+
+    std::vector<float> values(r.count);
+    std::memcpy(values.data(), data + sizeof(r), r.count * sizeof(float));
+    engine.storeMorphSnapshot(r.slot, std::move(values));
+}
+
+LfoConfig lfoConfig(const LfoRecord& r) {
+    LfoConfig config;
+    config.shape = static_cast<LfoShape>(std::min<uint8_t>(r.shape, static_cast<uint8_t>(LfoShape::RANDOM_WALK)));
+    config.tempo_sync = r.tempo_sync != 0;
+    config.rate = r.rate;
+    config.depth = r.depth;
+    config.center = r.center;
+    config.phase_offset = r.phase_offset;
+    config.target = static_cast<ModTarget>(std::min<uint8_t>(r.target, static_cast<uint8_t>(ModTarget::PITCH_BEND)));
+    config.channel = r.channel & 0x0F;
+    config.controller = r.controller & 0x7F;
+    return config;
+}
+
+void onLfo(LockFreeEngine& engine, const uint8_t* data, size_t) {
+    auto r = load<LfoRecord>(data);
+    engine.setLfo(r.index, lfoConfig(r));
+}
+
+void onLfoClear(LockFreeEngine& engine, const uint8_t* data, size_t) {
+    engine.clearLfo(load<ByteRecord>(data).value0);
+}
+
+void onAutomationLane(LockFreeEngine& engine, const uint8_t* data, size_t) {
+    auto r = load<AutomationLaneRecord>(data);
+    engine.setAutomationLane(r.lane, r.channel & 0x0F, r.controller & 0x7F);
+}
+
+void onAutomationClear(LockFreeEngine& engine, const uint8_t* data, size_t) {
+    engine.clearAutomation(load<ByteRecord>(data).value0);
+}
+
+void onAutomationPoints(LockFreeEngine& engine, const uint8_t* data, size_t size) {
+    auto r = load<AutomationPointsRecord>(data);
+    if (sizeof(r) + r.count * sizeof(AutomationPoint) > size) return;
+
+    std::vector<AutomationPoint> points(r.count);
+    std::memcpy(points.data(), data + sizeof(r), r.count * sizeof(AutomationPoint));
+    for (auto& point : points) {
+        point.value &= 0x3FFF;
+    }
+    engine.setAutomationPoints(r.lane, std::move(points));
+}
+
+void onAutomationArm(LockFreeEngine& engine, const uint8_t* data, size_t) {
+    auto r = load<ByteRecord>(data);
+    engine.armAutomation(r.value0, r.value1 != 0);
+}
+
+void onAutomationWrite(LockFreeEngine& engine, const uint8_t* data, size_t) {
+    auto r = load<AutomationWriteRecord>(data);
+    engine.writeAutomation(r.lane, r.value);
+}
+
+void onLoopLength(LockFreeEngine& engine, const uint8_t* data, size_t) {
+    engine.setLoopLength(load<LoopLengthRecord>(data).ticks);
+}
+
+// Server-Kommandos: der IPCServer antwortet selbst, die Engine ignoriert sie
+void onServer(LockFreeEngine&, const uint8_t*, size_t) {}
+
+struct Handler {
+    uint16_t min_size;
+    uint8_t messages;       // höchstens so viele Messages in die Out-Queue
+    void (*run)(LockFreeEngine& engine, const uint8_t* data, size_t size);
+};
+
+constexpr uint8_t MPE = MpeZone::MAX_MESSAGES;
+constexpr uint8_t MPE_CONFIG = 15 + MpeZone::MAX_MESSAGES;    // Note Off je Member-Kanal + Konfiguration
+static_assert(MPE_CONFIG <= MAX_RECORD_MESSAGES, "MAX_RECORD_MESSAGES zu klein");
+
+// 🚀 Sprungtabelle, Reihenfolge = Command
+const Handler HANDLERS[] = {
+    {sizeof(CcRecord), 1, onCc},
+    {sizeof(NoteRecord), 1, onNote},
+    {sizeof(BpmRecord), 0, onBpm},
+    {sizeof(BpmRampRecord), 0, onBpmRamp},
+    {sizeof(ByteRecord), 0, onClockMode},
+    {sizeof(Header), 0, onClockStart},
+    {sizeof(Header), 0, onClockStop},
+    {sizeof(ParamRecord), 0, onParam},
+    {sizeof(LearnRecord), 0, onLearn},
+    {sizeof(Header), 0, onLearnCancel},
+    {sizeof(MpeConfigRecord), MPE_CONFIG, onMpeConfig},
+    {sizeof(MpeOnRecord), MPE, onMpeOn},
+    {sizeof(MpeExprRecord), MPE, onMpeExpr},
+    {sizeof(ByteRecord), MPE, onMpeOff},
+    {sizeof(Cc14Record), 2, onCc14},
+    {sizeof(ParameterRecord), 4, onNrpn},
+    {sizeof(ParameterRecord), 4, onRpn},
+    {sizeof(MorphTargetsRecord), 0, onMorphTargets},
+    {sizeof(MorphSnapshotRecord), 0, onMorphSnapshot},
+    {sizeof(Header), 0, onServer},
+    {sizeof(LfoRecord), 0, onLfo},
+    {sizeof(ByteRecord), 0, onLfoClear},
+    {sizeof(AutomationLaneRecord), 0, onAutomationLane},
+    {sizeof(ByteRecord), 0, onAutomationClear},
+    {sizeof(AutomationPointsRecord), 0, onAutomationPoints},
+    {sizeof(ByteRecord), 0, onAutomationArm},
+    {sizeof(AutomationWriteRecord), 1, onAutomationWrite},
+    {sizeof(LoopLengthRecord), 0, onLoopLength},
+};
+
+static_assert(sizeof(HANDLERS) / sizeof(HANDLERS[0]) == CMD_COUNT, "Handler-Tabelle passt nicht zu Command");
+
+} // namespace
+
+int dispatchBinary(LockFreeEngine& engine, const uint8_t* data, size_t size) {
+    size_t offset = 0;
+    int budget = INT_MAX;
+    return dispatchBinary(engine, data, size, offset, budget);
+}
+
+int dispatchBinary(LockFreeEngine& engine, const uint8_t* data, size_t size, size_t& offset, int& budget) {
+    int count = 0;
+
+    while (offset < size) {
+        size_t left = size - offset;
+        if (left < sizeof(Header)) return -1;
+        Header header = load<Header>(data + offset);
+
+        if (header.version != VERSION || header.command >= CMD_COUNT ||
+            header.size > left || header.size < HANDLERS[header.command].min_size) {
+            return -1;
+        }
+
+        const Handler& handler = HANDLERS[header.command];
+        if (handler.messages > budget) break;
+        budget -= handler.messages;
+
+        handler.run(engine, data + offset, header.size);
+        offset += header.size;
+        count++;
+    }
+    return count;
+}
+
+bool dispatchJson(LockFreeEngine& engine, const std::string& json_str) {
+    try {
+        Json::Value root;
+        Json::Reader reader;
+        
+        if (reader.parse(json_str, root)) {
+            std::string type = root["type"].asString();
+            
+            if (type == "cc") {
+                int channel = root["channel"].asInt();
+                int controller = root["controller"].asInt();
+                int value = root["value"].asInt();
+                engine.sendMidiCC(channel, controller, value);
+                std::cout << "IPC: CC ch:" << channel << " ctrl:" << controller << " val:" << value << std::endl;
+            }
+            else if (type == "cc14") {
+                engine.sendMidiCC14(root["channel"].asInt(), root["controller"].asInt(), root["value"].asInt());
+            }
+            else if (type == "nrpn" || type == "rpn") {
+                int channel = root["channel"].asInt();
+                int parameter = root["parameter"].asInt();
+                int value = root["value"].asInt();
+                bool hires = !root.isMember("hires") || root["hires"].asBool();
+                if (type == "nrpn") engine.sendNrpn(channel, parameter, value, hires);
+                else engine.sendRpn(channel, parameter, value, hires);
+            }
+            else if (type == "note") {
+                int channel = root["channel"].asInt();
+                int note = root["note"].asInt();
+                int velocity = root["velocity"].asInt();
+                engine.sendMidiNote(channel, note, velocity);
+                std::cout << "IPC: Note ch:" << channel << " note:" << note << " vel:" << velocity << std::endl;
+            }
+            else if (type == "bpm") {
+                double bpm = root["bpm"].asDouble();
+                engine.setBpm(bpm);
+                std::cout << "IPC: BPM set to " << bpm << std::endl;
+            }
+            else if (type == "bpm_ramp") {
+                engine.rampBpm(root["bpm"].asDouble(), root["ticks"].asInt64());
+            }
+            else if (type == "clock_mode") {
+                int mode = root["mode"].asInt();
+                engine.setClockMode(mode);
+                std::cout << "IPC: Clock mode set to " << mode << std::endl;
+            }
+            else if (type == "clock_start") {
+                engine.startClock();
+                std::cout << "IPC: Clock started" << std::endl;
+            }
+            else if (type == "clock_stop") {
+                engine.stopClock();
+                std::cout << "IPC: Clock stopped" << std::endl;
+            }
+            else if (type == "mpe_config") {
+                engine.mpeConfigure(root["channels"].asInt(), root["bend_range"].asInt());
+            }
+            else if (type == "mpe_on") {
+                engine.mpeNoteOn(root["voice"].asInt(), root["note"].asInt(), root["velocity"].asInt(),
+                                  root["bend"].asDouble(), root["timbre"].asDouble());
+            }
+            else if (type == "mpe_expr") {
+                engine.mpeExpression(root["voice"].asInt(), root["bend"].asDouble(),
+                                      root["pressure"].asDouble(), root["timbre"].asDouble());
+            }
+            else if (type == "mpe_off") {
+                engine.mpeNoteOff(root["voice"].asInt(), root["velocity"].asInt());
+            }
+            else if (type == "morph_targets") {
+                // [[channel, controller, hires], ...]
+                std::vector<MorphTarget> targets;
+                for (const auto& t : root["targets"]) {
+                    targets.push_back(MorphTarget{static_cast<uint8_t>(t[0].asInt()),
+                                                  static_cast<uint8_t>(t[1].asInt()),
+                                                  t.size() > 2 && t[2].asBool()});
+                }
+                engine.setMorphTargets(std::move(targets));
+            }
+            else if (type == "morph_snapshot") {
+                std::vector<float> values;
+                for (const auto& v : root["values"]) {
+                    values.push_back(v.asFloat());
+                }
+                engine.storeMorphSnapshot(root["slot"].asInt(), std::move(values));
+            }
+            else if (type == "lfo") {
+                LfoRecord r{};
+                r.index = static_cast<uint8_t>(root["index"].asInt());
+                r.shape = static_cast<uint8_t>(root["shape"].asInt());
+                r.target = static_cast<uint8_t>(root["target"].asInt());
+                r.channel = static_cast<uint8_t>(root["channel"].asInt());
+                r.controller = static_cast<uint8_t>(root.isMember("controller") ? root["controller"].asInt() : 1);
+                r.tempo_sync = root["tempo_sync"].asBool() ? 1 : 0;
+                r.rate = root.isMember("rate") ? root["rate"].asFloat() : 1.0f;
+                r.depth = root.isMember("depth") ? root["depth"].asFloat() : 1.0f;
+                r.center = root.isMember("center") ? root["center"].asFloat() : 0.5f;
+                r.phase_offset = root["phase_offset"].asFloat();
+                engine.setLfo(r.index, lfoConfig(r));
+            }
+            else if (type == "lfo_clear") {
+                engine.clearLfo(root["index"].asInt());
+            }
+            else if (type == "automation_lane") {
+                engine.setAutomationLane(root["lane"].asInt(), root["channel"].asInt(), root["controller"].asInt());
+            }
+            else if (type == "automation_clear") {
+                engine.clearAutomation(root["lane"].asInt());
+            }
+            else if (type == "automation_points") {
+                // [[subtick, value14], ...]
+                std::vector<AutomationPoint> points;
+                for (const auto& p : root["points"]) {
+                    points.push_back(AutomationPoint{static_cast<uint32_t>(p[0].asUInt()),
+                                                     static_cast<uint16_t>(p[1].asInt() & 0x3FFF), 0});
+                }
+                engine.setAutomationPoints(root["lane"].asInt(), std::move(points));
+            }
+            else if (type == "automation_arm") {
+                engine.armAutomation(root["lane"].asInt(), root["armed"].asBool());
+            }
+            else if (type == "automation_write") {
+                engine.writeAutomation(root["lane"].asInt(), root["value"].asFloat());
+            }
+            else if (type == "loop_length") {
+                engine.setLoopLength(root["ticks"].asInt64());
+            }
+            else if (type == "param") {
+                int param = root["param"].asInt();
+                double value = root["value"].asDouble();
+                engine.setParameter(param, value);
+            }
+            else if (type == "learn") {
+                int param = root["param"].asInt();
+                engine.armLearn(param);
+                std::cout << "IPC: MIDI Learn armed for " << param << std::endl;
+            }
+            else if (type == "learn_cancel") {
+                engine.cancelLearn();
+                std::cout << "IPC: MIDI Learn cancelled" << std::endl;
+            }
+        } else {
+            std::cerr << "IPC Error: invalid JSON" << std::endl;
+            return false;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "IPC Error: " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace ipc
@@ -0,0 +1,206 @@
+#ifndef IPC_PROTOCOL_HPP
+#define IPC_PROTOCOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class LockFreeEngine;
+
+// 📦 Binäres IPC-Protokoll (Python -> Engine)
+//
+// Ein ZMQ-Frame enthält einen oder mehrere Records, jeder beginnt mit einem
+// 4-Byte Header. Alle Felder little-endian, feste Offsets, keine Zeiger -
+// app/midi.py packt dieselben Layouts mit struct ('<'). Neue Felder nur
+// hinten anhängen (size wächst, alte Server lesen den bekannten Anfang);
+// inkompatible Änderungen erhöhen VERSION.
+//
+// Frames, die mit '{' beginnen, sind JSON (Debug-Pfad, siehe dispatchJson).
+namespace ipc {
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "IPC-Records sind little-endian - Big-Endian Hosts bräuchten Byte-Swaps"
+#endif
+
+constexpr uint8_t VERSION = 1;
+
+enum Command : uint8_t {
+    CMD_CC = 0,
+    CMD_NOTE,
+    CMD_BPM,
+    CMD_BPM_RAMP,
+    CMD_CLOCK_MODE,
+    CMD_CLOCK_START,
+    CMD_CLOCK_STOP,
+    CMD_PARAM,
+    CMD_LEARN,
+    CMD_LEARN_CANCEL,
+    CMD_MPE_CONFIG,
+    CMD_MPE_ON,
+    CMD_MPE_EXPR,
+    CMD_MPE_OFF,
+    CMD_CC14,
+    CMD_NRPN,
+    CMD_RPN,
+    CMD_MORPH_TARGETS,
+    CMD_MORPH_SNAPSHOT,
+    CMD_STATS,          // nur Header, beantwortet der IPCServer (Session-Statistik als JSON)
+    CMD_LFO,
+    CMD_LFO_CLEAR,
+    CMD_AUTOMATION_LANE,
+    CMD_AUTOMATION_CLEAR,
+    CMD_AUTOMATION_POINTS,
+    CMD_AUTOMATION_ARM,
+    CMD_AUTOMATION_WRITE,   // auch über den Kommando-Ring (Touch-Fader)
+    CMD_LOOP_LENGTH,
+    CMD_COUNT
+};
+
+struct Header {
+    uint8_t version;
+    uint8_t command;
+    uint16_t size;      // Record inkl. Header in Bytes
+};
+
+struct CcRecord {           // CMD_CC
+    Header header;
+    uint8_t channel, controller, value, reserved;
+};
+
+struct NoteRecord {         // CMD_NOTE (velocity 0 = Note Off)
+    Header header;
+    uint8_t channel, note, velocity, reserved;
+};
+
+struct BpmRecord {          // CMD_BPM
+    Header header;
+    uint32_t reserved;
+    double bpm;
+};
+
+struct BpmRampRecord {      // CMD_BPM_RAMP
+    Header header;
+    int32_t ticks;
+    double bpm;
+};
+
+// CMD_CLOCK_MODE (mode), CMD_MPE_OFF (voice, velocity), CMD_LFO_CLEAR (index),
+// CMD_AUTOMATION_CLEAR (lane), CMD_AUTOMATION_ARM (lane, armed)
+struct ByteRecord {
+    Header header;
+    uint8_t value0, value1, reserved[2];
+};
+
+struct ParamRecord {        // CMD_PARAM
+    Header header;
+    uint8_t param, reserved[3];
+    float value;
+};
+
+struct LearnRecord {        // CMD_LEARN, min/max in 1/255
+    Header header;
+    uint8_t param, min, max, pickup;
+};
+
+struct MpeConfigRecord {    // CMD_MPE_CONFIG
+    Header header;
+    uint8_t channels, bend_range, reserved[2];
+};
+
+struct MpeOnRecord {        // CMD_MPE_ON
+    Header header;
+    uint8_t voice, note, velocity, reserved;
+    float bend, timbre;
+};
+
+struct MpeExprRecord {      // CMD_MPE_EXPR
+    Header header;
+    uint8_t voice, reserved[3];
+    float bend, pressure, timbre;
+};
+
+struct Cc14Record {         // CMD_CC14
+    Header header;
+    uint8_t channel, controller;
+    uint16_t value;
+};
+
+struct ParameterRecord {    // CMD_NRPN, CMD_RPN
+    Header header;
+    uint8_t channel, hires;
+    uint16_t parameter, value, reserved;
+};
+
+struct MorphTargetsRecord { // CMD_MORPH_TARGETS, danach count x {channel, controller, hires, 0}
+    Header header;
+    uint16_t count, reserved;
+};
+
+struct MorphSnapshotRecord { // CMD_MORPH_SNAPSHOT, danach count x float
+    Header header;
+    uint8_t slot, reserved;
+    uint16_t count;
+};
+
+struct LfoRecord {          // CMD_LFO, shape = LfoShape, target = ModTarget
+    Header header;
+    uint8_t index, shape, target, channel;
+    uint8_t controller, tempo_sync, reserved[2];
+    float rate, depth, center, phase_offset;
+};
+
+struct AutomationLaneRecord {    // CMD_AUTOMATION_LANE
+    Header header;
+    uint8_t lane, channel, controller, reserved;
+};
+
+struct AutomationPointsRecord {  // CMD_AUTOMATION_POINTS, danach count x AutomationPoint (8 Bytes)
+    Header header;
+    uint8_t lane, reserved;
+    uint16_t count;
+};
+
+struct AutomationWriteRecord {   // CMD_AUTOMATION_WRITE, value 0..1
+    Header header;
+    uint8_t lane, reserved[3];
+    float value;
+};
+
+struct LoopLengthRecord {        // CMD_LOOP_LENGTH in Clock-Ticks (24 PPQN)
+    Header header;
+    int32_t ticks;
+};
+
+static_assert(sizeof(Header) == 4, "IPC Layout");
+static_assert(sizeof(CcRecord) == 8 && sizeof(NoteRecord) == 8, "IPC Layout");
+static_assert(sizeof(BpmRecord) == 16 && sizeof(BpmRampRecord) == 16, "IPC Layout");
+static_assert(sizeof(ByteRecord) == 8 && sizeof(ParamRecord) == 12, "IPC Layout");
+static_assert(sizeof(LearnRecord) == 8 && sizeof(MpeConfigRecord) == 8, "IPC Layout");
+static_assert(sizeof(MpeOnRecord) == 16 && sizeof(MpeExprRecord) == 20, "IPC Layout");
+static_assert(sizeof(Cc14Record) == 8 && sizeof(ParameterRecord) == 12, "IPC Layout");
+static_assert(sizeof(MorphTargetsRecord) == 8 && sizeof(MorphSnapshotRecord) == 8, "IPC Layout");
+static_assert(sizeof(LfoRecord) == 28, "IPC Layout");
+static_assert(sizeof(AutomationLaneRecord) == 8 && sizeof(AutomationPointsRecord) == 8, "IPC Layout");
+static_assert(sizeof(AutomationWriteRecord) == 12 && sizeof(LoopLengthRecord) == 8, "IPC Layout");
+
+// Obergrenze der Output-Messages eines Records (MPE-Config: Note Offs aller
+// Member-Kanäle + Konfiguration). Auch die Kosten eines JSON-Frames.
+constexpr int MAX_RECORD_MESSAGES = 24;
+
+// Alle Records eines Frames ausführen. Ohne Allokation (außer Morph- und Automation-Records).
+// Gibt die Anzahl ausgeführter Records zurück, -1 bei kaputtem Frame
+// (Records davor sind bereits ausgeführt).
+int dispatchBinary(LockFreeEngine& engine, const uint8_t* data, size_t size);
+
+// Fortsetzbar, für Backpressure: Records ab offset ausführen, solange die
+// Obergrenze an Output-Messages des nächsten Records (NRPN 4, MPE bis 8, ...)
+// noch in budget passt. offset und budget werden fortgeschrieben,
+// offset == size heißt Frame fertig. Rückgabe wie oben.
+int dispatchBinary(LockFreeEngine& engine, const uint8_t* data, size_t size, size_t& offset, int& budget);
+
+// JSON-Debug-Pfad: ein Objekt {"type": ...} pro Frame
+bool dispatchJson(LockFreeEngine& engine, const std::string& json);
+
+} // namespace ipc
+
+#endif
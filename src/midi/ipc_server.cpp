@@ -1,100 +1,250 @@
 // ipc_server.cpp
-#include "lockfree_engine.hpp"
-#include <zmq.hpp>
-#include <thread>
+#include "ipc_server.hpp"
+#include "ipc_protocol.hpp"
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <sstream>
 #include <iostream>
-#include <json/json.h>
-
-class IPCServer {
-public:
-    IPCServer(LockFreeEngine& engine) : engine_(engine), running_(false) {}
-    
-    bool start() {
-        if (running_.exchange(true)) return false;
-        
+
+bool IPCServer::start(const char* address) {
+    if (running_.exchange(true)) return false;
+
+    // 🛑 Stop-Pipe: weckt den in zmq_poll blockierten Thread beim Beenden
+    stop_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (stop_fd_ < 0) {
+        std::cerr << "IPC Error: eventfd failed" << std::endl;
+        running_ = false;
+        return false;
+    }
+
+    // bind() wirft (z.B. Socket-Pfad ohne Schreibrecht) - hier abfangen, nicht in main
+    try {
         context_ = std::make_unique<zmq::context_t>(1);
-        socket_ = std::make_unique<zmq::socket_t>(*context_, ZMQ_PAIR);
-        socket_->bind("ipc:///tmp/tauwerk_midi");
-        
-        thread_ = std::thread(&IPCServer::run, this);
-        std::cout << "IPC Server started" << std::endl;
-        return true;
+        socket_ = std::make_unique<zmq::socket_t>(*context_, ZMQ_ROUTER);
+        socket_->set(zmq::sockopt::linger, 0);
+        socket_->bind(address);
+    } catch (const zmq::error_t& e) {
+        std::cerr << "IPC Error: cannot bind " << address << ": " << e.what() << std::endl;
+        socket_.reset();
+        context_.reset();
+        close(stop_fd_);
+        stop_fd_ = -1;
+        running_ = false;
+        return false;
+    }
+
+    thread_ = std::thread(&IPCServer::run, this);
+    std::cout << "IPC Server started" << std::endl;
+    return true;
+}
+
+void IPCServer::stop() {
+    if (!running_.exchange(false)) return;
+
+    uint64_t one = 1;
+    if (write(stop_fd_, &one, sizeof(one)) != sizeof(one)) {
+        std::cerr << "IPC Error: stop signal failed" << std::endl;
     }
-    
-    void stop() {
-        if (!running_.exchange(false)) return;
-        
-        if (thread_.joinable()) {
-            thread_.join();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    socket_->close();
+    context_->close();
+    close(stop_fd_);
+    stop_fd_ = -1;
+    std::cout << "IPC Server stopped" << std::endl;
+}
+
+// 💤 Blockiert in zmq_poll bis Daten oder Stop-Signal anliegen. Solange
+// noch Frames in Sessions warten, wird nur kurz nachgesehen (Timeout 0,
+// bei voller Out-Queue BACKPRESSURE_MS),
+// solange eine Automation-Lane armed ist alle TOUCH_POLL_MS (Touches aus
+// dem Kommando-Ring werden hier, nicht im Output-Thread, aufgezeichnet)
+void IPCServer::run() {
+    zmq::pollitem_t items[] = {
+        {static_cast<void*>(*socket_), 0, ZMQ_POLLIN, 0},
+        {nullptr, stop_fd_, ZMQ_POLLIN, 0},
+    };
+
+    while (running_.load()) {
+        int timeout_ms = throttled_ ? BACKPRESSURE_MS : pending_ > 0 ? 0 : engine_.automationArmed() ? TOUCH_POLL_MS : -1;
+        try {
+            zmq::poll(items, 2, std::chrono::milliseconds(timeout_ms));
+        } catch (const zmq::error_t& e) {
+            if (e.num() == EINTR) continue;
+            std::cerr << "IPC Error: poll failed: " << e.what() << std::endl;
+            break;
         }
-        
-        socket_->close();
-        context_->close();
-        std::cout << "IPC Server stopped" << std::endl;
+        if (items[1].revents & ZMQ_POLLIN) break;
+
+        receiveAll();
+        dispatchRound();
+        engine_.applyAutomationTouches();
+        expireSessions();
     }
-    
-private:
-    void run() {
-        while (running_.load()) {
-            zmq::message_t message;
-            
-            if (socket_->recv(message, zmq::recv_flags::dontwait)) {
-                processMessage(std::string(static_cast<char*>(message.data()), message.size()));
-            }
-            
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+// Anstehendes in die Session-Queues verteilen, Rest bleibt im Socket bis zur nächsten Runde
+void IPCServer::receiveAll() {
+    zmq::message_t identity;
+    zmq::message_t payload;
+
+    for (int i = 0; i < RECEIVE_PER_WAKEUP && socket_->recv(identity, zmq::recv_flags::dontwait); i++) {
+        if (!identity.more() || !socket_->recv(payload, zmq::recv_flags::dontwait)) continue;
+        // Weitere Teile (kein gültiger Client-Frame) verwerfen
+        while (payload.more()) {
+            zmq::message_t extra;
+            if (!socket_->recv(extra, zmq::recv_flags::dontwait)) break;
+            payload.move(extra);
         }
+
+        Session& session = sessionFor(identity);
+        session.frames++;
+        session.last_seen = std::chrono::steady_clock::now();
+        if (session.pending.size() >= MAX_PENDING) {
+            session.dropped++;
+            continue;
+        }
+        session.pending.push_back(std::move(payload));
+        pending_++;
+        payload = zmq::message_t();
     }
-    
-    void processMessage(const std::string& json_str) {
-        try {
-            Json::Value root;
-            Json::Reader reader;
-            
-            if (reader.parse(json_str, root)) {
-                std::string type = root["type"].asString();
-                
-                if (type == "cc") {
-                    int channel = root["channel"].asInt();
-                    int controller = root["controller"].asInt();
-                    int value = root["value"].asInt();
-                    engine_.sendMidiCC(channel, controller, value);
-                    std::cout << "IPC: CC ch:" << channel << " ctrl:" << controller << " val:" << value << std::endl;
-                }
-                else if (type == "note") {
-                    int channel = root["channel"].asInt();
-                    int note = root["note"].asInt();
-                    int velocity = root["velocity"].asInt();
-                    engine_.sendMidiNote(channel, note, velocity);
-                    std::cout << "IPC: Note ch:" << channel << " note:" << note << " vel:" << velocity << std::endl;
-                }
-                else if (type == "bpm") {
-                    double bpm = root["bpm"].asDouble();
-                    engine_.setBpm(bpm);
-                    std::cout << "IPC: BPM set to " << bpm << std::endl;
-                }
-                else if (type == "clock_mode") {
-                    int mode = root["mode"].asInt();
-                    engine_.setClockMode(mode);
-                    std::cout << "IPC: Clock mode set to " << mode << std::endl;
-                }
-                else if (type == "clock_start") {
-                    engine_.startClock();
-                    std::cout << "IPC: Clock started" << std::endl;
-                }
-                else if (type == "clock_stop") {
-                    engine_.stopClock();
-                    std::cout << "IPC: Clock stopped" << std::endl;
-                }
-            }
-        } catch (const std::exception& e) {
-            std::cerr << "IPC Error: " << e.what() << std::endl;
+}
+
+IPCServer::Session& IPCServer::sessionFor(const zmq::message_t& identity) {
+    std::string_view key(static_cast<const char*>(identity.data()), identity.size());
+    auto it = sessions_.find(key);
+    if (it != sessions_.end()) return it->second;
+
+    Session& session = sessions_.emplace(std::string(key), Session()).first->second;
+    session.id = ++next_session_id_;
+    session.routing_id = std::string(key);
+    std::cout << "IPC: client session " << session.id << " (" << printable(session.routing_id) << ")" << std::endl;
+    return session;
+}
+
+// Reihum, MESSAGES_PER_TURN pro Client und Runde (Deficit Round Robin)
+void IPCServer::dispatchRound() {
+    throttled_ = false;
+    if (sessions_.empty()) return;
+
+    auto start = sessions_.begin();
+    std::advance(start, round_start_++ % sessions_.size());
+    auto it = start;
+    do {
+        Session& session = it->second;
+        if (session.pending.empty()) {
+            session.credit = 0;     // kein Guthaben ansparen
+        } else {
+            // Ansparen nur bis zum teuersten Record - genug, damit jeder einmal drankommt
+            session.credit = std::min<int64_t>(session.credit + MESSAGES_PER_TURN, ipc::MAX_RECORD_MESSAGES);
+            const int64_t space = static_cast<int64_t>(engine_.outputSpace());
+            int budget = static_cast<int>(std::min(session.credit, space));
+            const int granted = budget;
+            while (!session.pending.empty() && runFront(session, budget)) {}
+            session.credit -= granted - budget;
+
+            // Output-Thread hinkt hinterher: später mit frischem Platz weiter
+            if (!session.pending.empty() && space < session.credit) throttled_ = true;
         }
+        if (++it == sessions_.end()) it = sessions_.begin();
+    } while (it != start);
+}
+
+// Vorderen Frame ab session.offset ausführen. false = nächster Record passt
+// nicht mehr ins Budget, der Frame bleibt für den nächsten Turn vorne stehen
+bool IPCServer::runFront(Session& session, int& budget) {
+    const zmq::message_t& message = session.pending.front();
+    if (!processMessage(session, static_cast<const uint8_t*>(message.data()), message.size(), budget)) {
+        return false;
+    }
+    session.pending.pop_front();
+    session.offset = 0;
+    pending_--;
+    return true;
+}
+
+// Kein Disconnect-Signal bei ROUTER: stille Sessions nach Timeout vergessen
+void IPCServer::expireSessions() {
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_expiry_ < std::chrono::seconds(10)) return;
+    last_expiry_ = now;
+
+    for (auto it = sessions_.begin(); it != sessions_.end(); ) {
+        if (it->second.pending.empty() && now - it->second.last_seen > std::chrono::seconds(SESSION_TIMEOUT_S)) {
+            std::cout << "IPC: client session " << it->second.id << " expired" << std::endl;
+            it = sessions_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// Binär-Records (ipc_protocol.hpp) oder JSON als Debug-Pfad, im Rahmen von
+// budget (Output-Messages). true = Frame fertig (oder kaputt und verworfen)
+bool IPCServer::processMessage(Session& session, const uint8_t* data, size_t size, int& budget) {
+    if (size > 0 && data[0] == '{') {
+        // Typ erst nach dem Parsen bekannt: wie der teuerste Record zählen
+        if (budget < ipc::MAX_RECORD_MESSAGES) return false;
+        budget -= ipc::MAX_RECORD_MESSAGES;
+        if (ipc::dispatchJson(engine_, std::string(reinterpret_cast<const char*>(data), size))) {
+            session.records++;
+        } else {
+            session.malformed++;
+        }
+        return true;
+    }
+    if (size == sizeof(ipc::Header) && data[1] == ipc::CMD_STATS) {
+        sendStats(session);
+        return true;
+    }
+    int records = ipc::dispatchBinary(engine_, data, size, session.offset, budget);
+    if (records < 0) {
+        session.malformed++;
+        std::cerr << "IPC Error: malformed frame (" << size << " bytes) from session " << session.id << std::endl;
+        return true;
+    }
+    session.records += records;
+    return session.offset == size;
+}
+
+// 📊 Antwort an genau diesen Client: eigene Session + Übersicht aller
+void IPCServer::sendStats(const Session& session) {
+    std::ostringstream out;
+    out << "{\"session\": " << session.id << ", \"clients\": [";
+    bool first = true;
+    for (const auto& entry : sessions_) {
+        const Session& s = entry.second;
+        out << (first ? "" : ", ") << "{\"session\": " << s.id
+            << ", \"name\": \"" << printable(s.routing_id) << "\""
+            << ", \"frames\": " << s.frames << ", \"records\": " << s.records
+            << ", \"malformed\": " << s.malformed << ", \"dropped\": " << s.dropped
+            << ", \"pending\": " << s.pending.size() << "}";
+        first = false;
+    }
+    out << "]}";
+
+    const std::string body = out.str();
+    socket_->send(zmq::buffer(session.routing_id.data(), session.routing_id.size()),
+                  zmq::send_flags::sndmore | zmq::send_flags::dontwait);
+    socket_->send(zmq::buffer(body.data(), body.size()), zmq::send_flags::dontwait);
+}
+
+// Routing-IDs sind Binärdaten (ZMQ-generiert) oder vom Client gesetzte Namen
+std::string IPCServer::printable(const std::string& id) {
+    bool text = !id.empty() && id[0] != '\0';
+    for (char c : id) {
+        if (c < 0x20 || c > 0x7E || c == '"' || c == '\\') text = false;
+    }
+    if (text) return id;
+
+    static const char* HEX = "0123456789abcdef";
+    std::string hex;
+    for (unsigned char c : id) {
+        hex += HEX[c >> 4];
+        hex += HEX[c & 0x0F];
     }
-    
-    LockFreeEngine& engine_;
-    std::atomic<bool> running_;
-    std::unique_ptr<zmq::context_t> context_;
-    std::unique_ptr<zmq::socket_t> socket_;
-    std::thread thread_;
-};
\ No newline at end of file
+    return hex;
+}
@@ -0,0 +1,82 @@
+#ifndef IPC_SERVER_HPP
+#define IPC_SERVER_HPP
+
+#include "lockfree_engine.hpp"
+#include <zmq.hpp>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// 👥 Mehrere Clients über ZMQ ROUTER (Clients: DEALER, ein Frame pro Nachricht).
+// Jeder Client (Routing-ID) bekommt eine Session mit eigener Warteschlange.
+// Pro Aufwachen werden höchstens RECEIVE_PER_WAKEUP Frames angenommen, dann
+// reihum abgearbeitet (Deficit Round Robin). Budgetiert wird in Output-
+// Messages (Obergrenze je Record: CC 1, NRPN 4, MPE bis 8, siehe
+// ipc_protocol): MESSAGES_PER_TURN pro Client und Runde, angespart bis zum
+// teuersten Record. Ein Turn führt nie mehr aus, als die Out-Queue der Engine
+// zu Beginn des Turns Platz hatte; große batch()-Frames werden mitten im
+// Frame unterbrochen und im nächsten Turn fortgesetzt. Reicht der Platz nicht,
+// wird nach BACKPRESSURE_MS erneut versucht. Ein flutender Client füllt nur
+// seine eigene Queue (Überlauf wird bei ihm verworfen und gezählt); die
+// anderen warten pro Runde höchstens einen Turn je Client.
+class IPCServer {
+public:
+    static constexpr size_t MAX_PENDING = 256;      // Frames pro Client
+    static constexpr int RECEIVE_PER_WAKEUP = 64;   // Frames
+    static constexpr int MESSAGES_PER_TURN = 16;    // Output-Messages
+    static constexpr int BACKPRESSURE_MS = 1;
+    static constexpr int64_t SESSION_TIMEOUT_S = 300;
+    static constexpr int TOUCH_POLL_MS = 20;        // Automation-Touches aufzeichnen, solange armed
+
+    IPCServer(LockFreeEngine& engine) : engine_(engine), running_(false) {}
+    ~IPCServer() { stop(); }
+
+    bool start(const char* address = "ipc:///tmp/tauwerk_midi");
+    void stop();
+
+private:
+    struct Session {
+        int id = 0;
+        std::string routing_id;
+        std::deque<zmq::message_t> pending;
+        int64_t frames = 0;
+        int64_t records = 0;
+        int64_t malformed = 0;
+        int64_t dropped = 0;        // Queue voll
+        int64_t credit = 0;         // Output-Messages
+        size_t offset = 0;          // Fortsetzung im vorderen Frame (Bytes)
+        std::chrono::steady_clock::time_point last_seen;
+    };
+
+    void run();
+    void receiveAll();
+    Session& sessionFor(const zmq::message_t& identity);
+    void dispatchRound();
+    bool runFront(Session& session, int& budget);
+    void expireSessions();
+    bool processMessage(Session& session, const uint8_t* data, size_t size, int& budget);
+    void sendStats(const Session& session);
+    static std::string printable(const std::string& id);
+
+    LockFreeEngine& engine_;
+    std::atomic<bool> running_;
+    int stop_fd_ = -1;
+    std::unique_ptr<zmq::context_t> context_;
+    std::unique_ptr<zmq::socket_t> socket_;
+    std::thread thread_;
+
+    // Gehört dem Server-Thread
+    std::map<std::string, Session, std::less<>> sessions_;    // find() per string_view
+    size_t pending_ = 0;
+    size_t round_start_ = 0;        // erste Session der Runde rotiert (Backpressure trifft nicht immer dieselben)
+    bool throttled_ = false;
+    int next_session_id_ = 0;
+    std::chrono::steady_clock::time_point last_expiry_;
+};
+
+#endif
@@ -1,10 +1,23 @@
 #include "lockfree_engine.hpp"
+#include "ipc_protocol.hpp"
+#include "rt_check.hpp"
 #include <iostream>
 #include <cstring>
 #include <thread>
+#include <algorithm>
+#include <cmath>
 #include <poll.h>
 
-LockFreeEngine::LockFreeEngine() : seq_handle_(nullptr), duplex_port_(-1) {
+LockFreeEngine::LockFreeEngine()
+    : seq_handle_(nullptr), duplex_port_(-1), time_(&steady_time_), sink_(nullptr) {
+    for (int i = 0; i < MAX_PARAMS; i++) {
+        params_[i].store(0.0f);
+    }
+    params_[PARAM_TEMPO].store((bpm_.load() - 20.0) / 280.0);
+    params_[PARAM_SWING].store(0.5f);
+    
+    std::lock_guard<std::mutex> lock(tempo_mutex_);
+    publishTempo({TempoSegment{0, bpm_.load(), bpm_.load(), 0}});
 }
 
 LockFreeEngine::~LockFreeEngine() {
@@ -25,6 +38,15 @@ bool LockFreeEngine::initialize() {
     }
     
     snd_seq_set_client_name(seq_handle_, "Tauwerk_LockFree");
+    
+#ifdef SND_SEQ_CLIENT_UMP_MIDI_2_0
+    // 🎼 UMP-Backend (alsa-lib >= 1.2.10, Kernel >= 6.5). Der Kernel übersetzt
+    // für MIDI-1.0 Ports, ältere Kernel lehnen ab -> MIDI 1.0 Events
+    ump_ = snd_seq_set_client_midi_version(seq_handle_, SND_SEQ_CLIENT_UMP_MIDI_2_0) >= 0;
+#endif
+    std::cout << "ALSA sequencer: " << (ump_ ? "UMP (MIDI 2.0)" : "MIDI 1.0") << std::endl;
+    // Non-blocking: Input-Loop endet bei leerer Queue, Output blockiert nie den RT-Thread
+    snd_seq_nonblock(seq_handle_, 1);
     snd_seq_set_output_buffer_size(seq_handle_, 65536);
     
     duplex_port_ = snd_seq_create_simple_port(seq_handle_, "Tauwerk",
@@ -32,7 +54,6 @@ bool LockFreeEngine::initialize() {
         SND_SEQ_PORT_CAP_SUBS_READ | SND_SEQ_PORT_CAP_SUBS_WRITE,
         SND_SEQ_PORT_TYPE_MIDI_GENERIC | SND_SEQ_PORT_TYPE_APPLICATION);
     
-    calculateInterval();
     return true;
 }
 
@@ -45,6 +66,15 @@ bool LockFreeEngine::start() {
     pthread_create(&clock_thread_, nullptr, &LockFreeEngine::clockThread, this);
     pthread_create(&midi_in_thread_, nullptr, &LockFreeEngine::midiInThread, this);
     pthread_create(&midi_out_thread_, nullptr, &LockFreeEngine::midiOutThread, this);
+    if (rt_priority_ > 0) {
+        configureRealtime();
+    }
+    
+    // MPE Configuration Message an die angeschlossenen Synths
+    if (mpe_.enabled()) {
+        MidiMessage out[MpeZone::MAX_MESSAGES];
+        pushOut(out, mpe_.configuration(out));
+    }
     
     std::cout << "LockFree Engine started" << std::endl;
     return true;
@@ -62,20 +92,150 @@ void LockFreeEngine::stop() {
     std::cout << "LockFree Engine stopped" << std::endl;
 }
 
+int LockFreeEngine::shutdown() {
+    clock_running_.store(false);
+    stop();
+    
+    // Threads sind beendet: dieser Thread ist jetzt der einzige Consumer
+    drainOutput();
+    
+    int released = 0;
+    const int64_t now = time_->now();
+    for (int channel = 0; channel < 16; channel++) {
+        if (!held_notes_[channel][0] && !held_notes_[channel][1]) continue;
+        for (int note = 0; note < 128; note++) {
+            if (held_notes_[channel][note >> 6] & (1ULL << (note & 63))) {
+                sendMidiMessage(MidiMessage(0x80 | channel, note, 0, now));
+                released++;
+            }
+        }
+        sendMidiMessage(MidiMessage(0xB0 | channel, 64, 0, now));   // Sustain aus
+    }
+    return released;
+}
+
+void LockFreeEngine::setRealtime(int priority, int cpu) {
+    if (running_.load()) return;
+    rt_priority_ = std::max(0, std::min(99, priority));
+    rt_cpu_ = cpu;
+}
+
+// Nach pthread_create: Clock vor Output vor Input
+bool LockFreeEngine::configureRealtime() {
+    struct {
+        pthread_t thread;
+        int offset;
+    } threads[] = {{clock_thread_, 0}, {midi_out_thread_, 1}, {midi_in_thread_, 2}};
+    
+    bool ok = true;
+    for (const auto& t : threads) {
+        sched_param param{};
+        param.sched_priority = std::max(1, rt_priority_ - t.offset);
+        int err = pthread_setschedparam(t.thread, SCHED_FIFO, &param);
+        if (err != 0) {
+            std::cerr << "WARNING: SCHED_FIFO " << param.sched_priority << " failed - " << strerror(err) << std::endl;
+            ok = false;
+        }
+        if (rt_cpu_ >= 0) {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(rt_cpu_, &cpus);
+            err = pthread_setaffinity_np(t.thread, sizeof(cpus), &cpus);
+            if (err != 0) {
+                std::cerr << "WARNING: CPU affinity " << rt_cpu_ << " failed - " << strerror(err) << std::endl;
+                ok = false;
+            }
+        }
+    }
+    return ok;
+}
+
 // 🎵 Clock Control Funktionen
+namespace {
+
+// 🎚 14-bit CC: MSB (controller 0..31) + LSB (controller + 32)
+int cc14Messages(int channel, int controller, int value, MidiMessage* out) {
+    value = std::min(16383, std::max(0, value));
+    out[0] = MidiMessage(0xB0 | channel, controller, value >> 7);
+    out[1] = MidiMessage(0xB0 | channel, controller + 32, value & 0x7F);
+    return 2;
+}
+
+// Adresse (MSB, LSB) + Data Entry 6 (+ 38). Kein RPN-Null danach - sonst
+// müsste jede Folgeänderung die Adresse neu senden.
+int parameterMessages(int channel, uint8_t msb_cc, int parameter, int value, bool hires, MidiMessage* out) {
+    uint8_t status = 0xB0 | channel;
+    value = std::min(hires ? 16383 : 127, std::max(0, value));
+    out[0] = MidiMessage(status, msb_cc, parameter >> 7);
+    out[1] = MidiMessage(status, msb_cc - 1, parameter & 0x7F);
+    out[2] = MidiMessage(status, 6, hires ? value >> 7 : value);
+    out[3] = MidiMessage(status, 38, value & 0x7F);
+    return hires ? 4 : 3;
+}
+
+// Nur das am Tick aktive Segment behalten (evtl. laufende Rampe), spätere verwerfen
+std::vector<TempoSegment> cutTempo(const std::vector<TempoSegment>& segments, int64_t tick) {
+    std::vector<TempoSegment> kept;
+    for (const TempoSegment& s : segments) {
+        if (s.start_tick >= tick) break;
+        kept.assign(1, s);
+    }
+    return kept;
+}
+
+} // namespace
+
 void LockFreeEngine::setBpm(double bpm) {
+    bpm = std::min(300.0, std::max(20.0, bpm));
     bpm_.store(bpm);
-    calculateInterval();
+    {
+        std::lock_guard<std::mutex> lock(tempo_mutex_);
+        int64_t tick = tick_counter_.load();
+        std::vector<TempoSegment> segments = cutTempo(tempo_segments_, tick);
+        segments.push_back(TempoSegment{tick, bpm, bpm, 0});
+        publishTempo(std::move(segments));
+    }
+    params_[PARAM_TEMPO].store((bpm - 20.0) / 280.0);
+    learn_.invalidatePickup(PARAM_TEMPO);
     std::cout << "BPM set to: " << bpm << std::endl;
 }
 
+void LockFreeEngine::rampBpm(double bpm, int64_t ticks) {
+    bpm = std::min(300.0, std::max(20.0, bpm));
+    {
+        std::lock_guard<std::mutex> lock(tempo_mutex_);
+        int64_t tick = tick_counter_.load();
+        std::vector<TempoSegment> segments = cutTempo(tempo_segments_, tick);
+        // Start beim aktuellen Tempo (bpm_ folgt der Map bzw. MIDI Learn)
+        segments.push_back(TempoSegment{tick, bpm_.load(), bpm, std::max<int64_t>(0, ticks)});
+        publishTempo(std::move(segments));
+    }
+    params_[PARAM_TEMPO].store((bpm - 20.0) / 280.0);
+    learn_.invalidatePickup(PARAM_TEMPO);
+    std::cout << "BPM ramp to: " << bpm << " over " << ticks << " ticks" << std::endl;
+}
+
+void LockFreeEngine::setTempoMap(std::vector<TempoSegment> segments) {
+    std::lock_guard<std::mutex> lock(tempo_mutex_);
+    publishTempo(std::move(segments));
+}
+
+// Editor-Seite, tempo_mutex_ gehalten. Der Clock-Thread übernimmt die Map am nächsten Tick.
+void LockFreeEngine::publishTempo(std::vector<TempoSegment> segments) {
+    TempoMap* map = new TempoMap(std::move(segments));
+    tempo_segments_ = map->segments();
+    tempo_.publish(map);
+}
+
 void LockFreeEngine::startClock() {
     clock_running_.store(true);
+    transport_seq_.fetch_add(1);
     std::cout << "Clock started" << std::endl;
 }
 
 void LockFreeEngine::stopClock() {
     clock_running_.store(false);
+    transport_seq_.fetch_add(1);
     std::cout << "Clock stopped" << std::endl;
 }
 
@@ -84,33 +244,338 @@ void LockFreeEngine::setClockMode(int mode) {
     std::cout << "Clock mode set to: " << mode << std::endl;
 }
 
+// 🌊 Modulation
+bool LockFreeEngine::setLfo(int index, const LfoConfig& config) {
+    return modulation_.configure(index, config);
+}
+
+bool LockFreeEngine::clearLfo(int index) {
+    return modulation_.disable(index);
+}
+
+// 🎚 Automation
+void LockFreeEngine::setLoopLength(int64_t ticks) {
+    if (ticks < 1) ticks = 1;
+    loop_length_ticks_.store(ticks);
+    std::cout << "Loop length set to: " << ticks << " ticks" << std::endl;
+}
+
+bool LockFreeEngine::setAutomationLane(int lane, int channel, int controller) {
+    return automation_.setLane(lane, channel, controller);
+}
+
+bool LockFreeEngine::setAutomationPoints(int lane, std::vector<AutomationPoint> points) {
+    return automation_.setPoints(lane, std::move(points));
+}
+
+bool LockFreeEngine::clearAutomation(int lane) {
+    return automation_.clearLane(lane);
+}
+
+void LockFreeEngine::armAutomation(int lane, bool armed) {
+    automation_.arm(lane, armed);
+}
+
+void LockFreeEngine::writeAutomation(int lane, float value) {
+    value = std::min(1.0f, std::max(0.0f, value));
+    uint16_t value14 = static_cast<uint16_t>(value * 16383.0f + 0.5f);
+    
+    if (clock_running_.load()) {
+        uint32_t loop_subticks;
+        uint32_t subtick = automationPosition(loop_subticks);
+        automation_.record(lane, subtick, loop_subticks, value14);
+    }
+    
+    // Live-Wert sofort senden
+    uint8_t channel, controller;
+    if (automation_.target(lane, channel, controller)) {
+        sendMidiCC(channel, controller, value14 >> 7);
+    }
+}
+
+int LockFreeEngine::applyAutomationTouches() {
+    return automation_.applyTouches();
+}
+
+// Aktuelle Position im Loop in Subticks (RT-sicher)
+uint32_t LockFreeEngine::automationPosition(uint32_t& loop_subticks) const {
+    const int64_t loop = loop_length_ticks_.load();
+    double position = std::fmod(tickPosition(time_->now()), static_cast<double>(loop));
+    loop_subticks = static_cast<uint32_t>(loop * AutomationEngine::SUBTICKS);
+    return static_cast<uint32_t>(position * AutomationEngine::SUBTICKS);
+}
+
+// 🔀 Preset-Morph
+bool LockFreeEngine::setMorphTargets(std::vector<MorphTarget> targets) {
+    size_t count = targets.size();
+    if (!morph_.setTargets(std::move(targets))) {
+        std::cerr << "ERROR: Invalid morph targets" << std::endl;
+        return false;
+    }
+    std::cout << "Morph targets set: " << count << std::endl;
+    return true;
+}
+
+bool LockFreeEngine::storeMorphSnapshot(int slot, std::vector<float> values) {
+    if (!morph_.storeSnapshot(slot, std::move(values))) {
+        std::cerr << "ERROR: Morph snapshot " << slot << " does not match "
+                  << morph_.targetCount() << " targets" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void LockFreeEngine::setMorphBudget(int messages_per_tick) {
+    morph_budget_.store(std::min(MorphEngine::MAX_MESSAGES, std::max(1, messages_per_tick)));
+}
+
+// 🎹 MPE
+void LockFreeEngine::mpeConfigure(int member_channels, int bend_range) {
+    MidiMessage out[MpeZone::MAX_MESSAGES];
+    int count;
+    while ((count = mpe_.allNotesOff(out, MpeZone::MAX_MESSAGES)) > 0) {
+        pushOut(out, count);
+    }
+    
+    mpe_.configure(member_channels, bend_range);
+    if (running_.load()) {
+        pushOut(out, mpe_.configuration(out));
+    }
+    std::cout << "MPE zone: " << mpe_.memberChannels() << " member channels" << std::endl;
+}
+
+void LockFreeEngine::mpeNoteOn(int voice, int note, int velocity, float bend, float timbre) {
+    MidiMessage out[MpeZone::MAX_MESSAGES];
+    pushOut(out, mpe_.noteOn(voice, note, velocity, bend, timbre, out));
+}
+
+void LockFreeEngine::mpeExpression(int voice, float bend, float pressure, float timbre) {
+    MidiMessage out[MpeZone::MAX_MESSAGES];
+    pushOut(out, mpe_.expression(voice, bend, pressure, timbre, out));
+}
+
+void LockFreeEngine::mpeNoteOff(int voice, int velocity) {
+    MidiMessage out[MpeZone::MAX_MESSAGES];
+    pushOut(out, mpe_.noteOff(voice, velocity, out));
+}
+
+// Mehrere Messages in Reihenfolge in die API-Queue
+void LockFreeEngine::pushOut(const MidiMessage* messages, int count) {
+    // Blockweise pushen: der Output-Thread sieht zusammengehörige Messages
+    // (MSB/LSB, NRPN-Sequenz) gemeinsam
+    constexpr int BATCH = 16;
+    int64_t now = time_->now();
+    for (int i = 0; i < count; i += BATCH) {
+        MidiMessage batch[BATCH];
+        int n = std::min(BATCH, count - i);
+        for (int j = 0; j < n; j++) {
+            batch[j] = messages[i + j];
+            batch[j].timestamp = now;
+        }
+        int pushed = static_cast<int>(midi_out_queue_.push(batch, n));
+        if (pushed < n) {
+            stats_out_overflows_.fetch_add(n - pushed);
+        }
+    }
+}
+
+// 🎓 Parameter & MIDI Learn
+void LockFreeEngine::setParameter(int param, float value) {
+    if (param < 0 || param >= MAX_PARAMS) return;
+    applyParameter(param, std::min(1.0f, std::max(0.0f, value)));
+    learn_.invalidatePickup(param);
+}
+
+float LockFreeEngine::getParameter(int param) const {
+    if (param < 0 || param >= MAX_PARAMS) return 0.0f;
+    return params_[param].load();
+}
+
+void LockFreeEngine::armLearn(int param, float min, float max, bool pickup) {
+    auto to8 = [](float v) { return static_cast<uint8_t>(std::min(1.0f, std::max(0.0f, v)) * 255.0f + 0.5f); };
+    learn_.arm(param, to8(min), to8(max), pickup);
+    std::cout << "MIDI Learn armed for parameter " << param << std::endl;
+}
+
+void LockFreeEngine::cancelLearn() {
+    learn_.cancel();
+}
+
+// Parameter schreiben - RT-sicher (nur Atomics), auch aus dem MIDI-In Thread
+void LockFreeEngine::applyParameter(int param, float value) {
+    params_[param].store(value);
+    
+    if (param == PARAM_TEMPO) {
+        // Clock-Thread übernimmt das Tempo am nächsten Tick (ohne Map-Neubau)
+        double bpm = 20.0 + value * 280.0;
+        bpm_.store(bpm);
+        tempo_request_bpm_.store(bpm);
+        tempo_request_seq_.fetch_add(1, std::memory_order_release);
+    }
+}
+
+// 🔀 Routing
+bool LockFreeEngine::connectOutput(const char* address) {
+    snd_seq_addr_t addr;
+    if (!seq_handle_ || snd_seq_parse_address(seq_handle_, &addr, address) < 0) {
+        std::cerr << "ERROR: Invalid output address " << address << std::endl;
+        return false;
+    }
+    // Neuer Empfänger: dessen Controller-Zustand ist unbekannt
+    controllers_reset_.store(true);
+    return snd_seq_connect_to(seq_handle_, duplex_port_, addr.client, addr.port) >= 0;
+}
+
+bool LockFreeEngine::connectInput(const char* address) {
+    snd_seq_addr_t addr;
+    if (!seq_handle_ || snd_seq_parse_address(seq_handle_, &addr, address) < 0) {
+        std::cerr << "ERROR: Invalid input address " << address << std::endl;
+        return false;
+    }
+    return snd_seq_connect_from(seq_handle_, duplex_port_, addr.client, addr.port) >= 0;
+}
+
+void LockFreeEngine::setThru(bool enabled) {
+    thru_enabled_.store(enabled);
+    std::cout << "MIDI Thru " << (enabled ? "on" : "off") << std::endl;
+}
+
+// 🧪 Zeitquelle / Sink
+void LockFreeEngine::setTimeSource(TimeSource* source) {
+    if (running_.load()) return;
+    time_ = source ? source : &steady_time_;
+}
+
+void LockFreeEngine::setSink(MidiSink* sink) {
+    if (running_.load()) return;
+    sink_ = sink;
+}
+
+bool LockFreeEngine::attachCommandRing(const char* name) {
+    if (running_.load()) return false;
+    return commands_.create(name);
+}
+
+int64_t LockFreeEngine::renderOffline(int64_t duration_ns) {
+    if (running_.load()) {
+        return -1;
+    }
+    
+    int64_t start_ticks = stats_clock_ticks_.load();
+    int64_t now = time_->now();
+    const int64_t end = now + duration_ns;
+    
+    // Gleicher Ablauf wie clockThread + midiOutThread, nur ohne Threads
+    while (now < end) {
+        int64_t deadline = clockStep(now);
+        drainOutput();
+        
+        if (deadline >= end) break;
+        time_->sleepUntil(deadline);
+        now = time_->now();
+    }
+    
+    time_->sleepUntil(end);
+    drainOutput();
+    return stats_clock_ticks_.load() - start_ticks;
+}
+
 // Thread Implementations
 void* LockFreeEngine::clockThread(void* arg) {
     LockFreeEngine* engine = static_cast<LockFreeEngine*>(arg);
     
-    auto next_tick = std::chrono::steady_clock::now();
+    // Max. Schlafdauer, damit stop() / stopClock() schnell greifen
+    constexpr int64_t MAX_SLEEP_NS = 1'000'000;
+    
+    rt_check::enterRealtime("clock");
     
     while (engine->running_.load()) {
-        if (engine->clock_running_.load()) {
-            auto now = std::chrono::steady_clock::now();
-            
-            if (now >= next_tick) {
-                engine->processClockTick();
-                
-                int64_t interval = engine->tick_interval_ns_.load();
-                next_tick += std::chrono::nanoseconds(interval);
-                engine->stats_clock_ticks_.fetch_add(1);
-            }
-            
-            std::this_thread::sleep_for(std::chrono::microseconds(100));
-        } else {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        }
+        int64_t now = engine->time_->now();
+        int64_t deadline = engine->clockStep(now);
+        
+        rt_check::Allow wait(rt_check::ALLOW_WAIT, "clock sleep");
+        engine->time_->sleepUntil(std::min(deadline, now + MAX_SLEEP_NS));
     }
     
+    rt_check::leaveRealtime();
     return nullptr;
 }
 
+// ⏱ Ein Clock-Schritt: fällige Control- und Clock-Ticks verarbeiten,
+// nächste Deadline zurückgeben
+int64_t LockFreeEngine::clockStep(int64_t now) {
+    if (now >= next_control_ns_) {
+        processControlTick(now);
+        next_control_ns_ += CONTROL_INTERVAL_NS;
+        if (next_control_ns_ <= now) {
+            next_control_ns_ = now + CONTROL_INTERVAL_NS; // Nach Aussetzern nicht nachholen
+        }
+    }
+    
+    if (!clock_running_.load()) {
+        clock_was_running_ = false;
+        return next_control_ns_;
+    }
+    
+    // Clock (neu) gestartet: erster Tick sofort, kein Nachholen alter Ticks
+    if (!clock_was_running_) {
+        next_tick_ns_ = now;
+        next_tick_index_ = tick_counter_.load();
+        clock_was_running_ = true;
+        anchorTempo(next_tick_index_, now);
+    } else if (tempo_.acquire() != tempo_map_ ||
+               tempo_request_seq_.load(std::memory_order_acquire) != tempo_request_seen_) {
+        // Neues Tempo ab dem anstehenden Tick, dessen Deadline bleibt
+        anchorTempo(next_tick_index_, next_tick_ns_);
+    }
+    
+    if (now >= next_tick_ns_) {
+        int64_t latency = now - next_tick_ns_;
+        if (latency > stats_max_latency_ns_.load()) {
+            stats_max_latency_ns_.store(latency);
+        }
+        
+        processClockTick(next_tick_ns_);
+        
+        int64_t deadline = tickDeadline(++next_tick_index_);
+        tick_interval_ns_.store(deadline - next_tick_ns_);
+        bpm_.store(tempo_override_ > 0.0 ? tempo_override_ : tempo_map_->bpmAt(next_tick_index_, tempo_cursor_));
+        next_tick_ns_ = deadline;
+        stats_clock_ticks_.fetch_add(1);
+    }
+    
+    return std::min(next_tick_ns_, next_control_ns_);
+}
+
+// Tempo-Anker setzen: Deadlines ab hier aus Map (oder Override) relativ zu (tick, time)
+void LockFreeEngine::anchorTempo(int64_t tick, int64_t time) {
+    const TempoMap* map = tempo_.acquire();
+    if (map != tempo_map_) {
+        tempo_map_ = map;
+        tempo_cursor_ = 0;
+        tempo_override_ = 0.0;
+    }
+    uint32_t seq = tempo_request_seq_.load(std::memory_order_acquire);
+    if (seq != tempo_request_seen_) {
+        tempo_request_seen_ = seq;
+        tempo_override_ = tempo_request_bpm_.load();
+        override_period_ = TempoMap::period(tempo_override_);
+    }
+    
+    anchor_tick_ = tick;
+    anchor_ns_ = time;
+    anchor_offset_ = tempo_map_->tickTime(tick, tempo_cursor_);
+}
+
+// Deadline von Tick n: ab Anker in 64.64 Festkomma, erst am Ende auf ns gerundet.
+// Kein Aufaddieren gerundeter Intervalle -> keine Drift, auch nach Stunden.
+int64_t LockFreeEngine::tickDeadline(int64_t tick) {
+    FixedNs offset = tempo_override_ > 0.0
+        ? (tick - anchor_tick_) * override_period_
+        : tempo_map_->tickTime(tick, tempo_cursor_) - anchor_offset_;
+    return anchor_ns_ + TempoMap::toNs(offset);
+}
+
 void* LockFreeEngine::midiInThread(void* arg) {
     LockFreeEngine* engine = static_cast<LockFreeEngine*>(arg);
     
@@ -119,11 +584,53 @@ void* LockFreeEngine::midiInThread(void* arg) {
     struct pollfd pfds[npfd];
     snd_seq_poll_descriptors(engine->seq_handle_, pfds, npfd, POLLIN);
     
+    rt_check::enterRealtime("midi_in");
+    
     while (engine->running_.load()) {
-        if (poll(pfds, npfd, 100) > 0) { // 100ms timeout
+        int ready;
+        {
+            rt_check::Allow wait(rt_check::ALLOW_WAIT, "alsa poll");
+            ready = poll(pfds, npfd, 100); // 100ms timeout
+        }
+        
+        if (ready > 0) {
+#ifdef SND_SEQ_CLIENT_UMP_MIDI_2_0
+            if (engine->ump_) {
+                snd_seq_ump_event_t* ev = nullptr;
+                
+                while (true) {
+                    int result;
+                    {
+                        rt_check::Allow io(rt_check::ALLOW_IO, "alsa input");
+                        result = snd_seq_ump_event_input(engine->seq_handle_, &ev);
+                    }
+                    if (result <= 0) break;
+                    if (!ev) continue;
+                    
+                    if (ev->flags & SND_SEQ_EVENT_UMP) {
+                        MidiMessage msg;
+                        msg.words[0] = ev->ump[0];
+                        msg.words[1] = ev->ump[1];
+                        msg.timestamp = engine->time_->now();
+                        engine->processInput(msg);
+                    } else {
+                        // Header und Daten sind layoutgleich zu snd_seq_event_t
+                        engine->processMidiInEvent(reinterpret_cast<snd_seq_event_t*>(ev));
+                    }
+                }
+                continue;
+            }
+#endif
             snd_seq_event_t* ev = nullptr;
             
-            while (snd_seq_event_input(engine->seq_handle_, &ev) > 0) {
+            while (true) {
+                int result;
+                {
+                    rt_check::Allow io(rt_check::ALLOW_IO, "alsa input");
+                    result = snd_seq_event_input(engine->seq_handle_, &ev);
+                }
+                if (result <= 0) break;
+                
                 if (ev) {
                     engine->processMidiInEvent(ev);
                     snd_seq_free_event(ev);
@@ -132,104 +639,393 @@ void* LockFreeEngine::midiInThread(void* arg) {
         }
     }
     
+    rt_check::leaveRealtime();
     return nullptr;
 }
 
 void* LockFreeEngine::midiOutThread(void* arg) {
     LockFreeEngine* engine = static_cast<LockFreeEngine*>(arg);
     
+    rt_check::enterRealtime("midi_out");
+    
     while (engine->running_.load()) {
-        MidiMessage msg;
+        engine->drainOutput();
         
-        // 🔄 Outgoing Messages verarbeiten
-        while (engine->midi_out_queue_.pop(msg)) {
-            engine->sendMidiMessage(msg);
+        rt_check::Allow wait(rt_check::ALLOW_WAIT, "out sleep");
+        if (engine->commands_.attached()) {
+            // Doorbell: Kommando aus dem Ring weckt sofort statt nach bis zu 100 µs
+            engine->commands_.wait(100'000);
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
         }
-        
-        std::this_thread::sleep_for(std::chrono::microseconds(100));
     }
     
+    rt_check::leaveRealtime();
     return nullptr;
 }
 
+// 🔄 Outgoing Messages verarbeiten - Clock zuerst (timing-kritisch)
+void LockFreeEngine::drainOutput() {
+    if (controllers_reset_.exchange(false)) {
+        controllers_.reset();
+    }
+    drainQueue(clock_out_queue_);
+    drainQueue(thru_queue_);
+    drainQueue(midi_out_queue_);
+    drainCommands();
+}
+
+// Eine Message Lookahead, damit MSB/LSB-Paare als Paar erkannt werden
+void LockFreeEngine::drainQueue(MidiQueue& queue) {
+    MidiMessage msg;
+    while (queue.pop(msg)) {
+        const MidiMessage* next = queue.read_available() > 0 ? &queue.front() : nullptr;
+        if (controllers_.filter(msg, next)) {
+            sendMidiMessage(msg);
+        } else {
+            stats_redundant_.fetch_add(1);
+        }
+    }
+}
+
+// Zusammengehörige Messages (ein Kommando) mit Lookahead innerhalb des Blocks
+void LockFreeEngine::sendFiltered(const MidiMessage* messages, int count) {
+    for (int i = 0; i < count; i++) {
+        if (controllers_.filter(messages[i], i + 1 < count ? &messages[i + 1] : nullptr)) {
+            sendMidiMessage(messages[i]);
+        } else {
+            stats_redundant_.fetch_add(1);
+        }
+    }
+}
+
+// ⚡ Kommando-Ring: Records direkt im Output-Thread ausführen (ohne API-Queue)
+void LockFreeEngine::drainCommands() {
+    if (!commands_.attached()) return;
+    
+    const uint8_t* record;
+    while ((record = commands_.peek()) != nullptr) {
+        ipc::Header header;
+        std::memcpy(&header, record, sizeof(header));
+        MidiMessage out[4];
+        int count = 0;
+        
+        if (header.version == ipc::VERSION && header.size <= command_ring::SLOT_SIZE) {
+            switch (header.command) {
+                case ipc::CMD_CC: {
+                    ipc::CcRecord r;
+                    std::memcpy(&r, record, sizeof(r));
+                    out[count++] = MidiMessage(0xB0 | (r.channel & 0x0F), r.controller & 0x7F, r.value & 0x7F);
+                    break;
+                }
+                case ipc::CMD_NOTE: {
+                    ipc::NoteRecord r;
+                    std::memcpy(&r, record, sizeof(r));
+                    uint8_t status = r.velocity > 0 ? 0x90 : 0x80;
+                    out[count++] = MidiMessage(status | (r.channel & 0x0F), r.note & 0x7F, r.velocity & 0x7F);
+                    break;
+                }
+                case ipc::CMD_CC14: {
+                    ipc::Cc14Record r;
+                    std::memcpy(&r, record, sizeof(r));
+                    count = cc14Messages(r.channel & 0x0F, r.controller & 0x1F, r.value, out);
+                    break;
+                }
+                case ipc::CMD_NRPN:
+                case ipc::CMD_RPN: {
+                    ipc::ParameterRecord r;
+                    std::memcpy(&r, record, sizeof(r));
+                    uint8_t msb_cc = header.command == ipc::CMD_NRPN ? 99 : 101;
+                    count = parameterMessages(r.channel & 0x0F, msb_cc, r.parameter & 0x3FFF, r.value, r.hires != 0, out);
+                    break;
+                }
+                case ipc::CMD_PARAM: {
+                    ipc::ParamRecord r;
+                    std::memcpy(&r, record, sizeof(r));
+                    setParameter(r.param, r.value);
+                    break;
+                }
+                case ipc::CMD_AUTOMATION_WRITE: {
+                    // Live-CC sofort, Aufnahme erst im Editor-Thread (applyAutomationTouches)
+                    ipc::AutomationWriteRecord r;
+                    std::memcpy(&r, record, sizeof(r));
+                    float value = std::min(1.0f, std::max(0.0f, r.value));
+                    uint16_t value14 = static_cast<uint16_t>(value * 16383.0f + 0.5f);
+                    if (clock_running_.load()) {
+                        uint32_t loop_subticks;
+                        uint32_t subtick = automationPosition(loop_subticks);
+                        automation_.touch(r.lane, subtick, loop_subticks, value14);
+                    }
+                    uint8_t channel, controller;
+                    if (automation_.target(r.lane, channel, controller)) {
+                        out[count++] = MidiMessage(0xB0 | channel, controller, value14 >> 7);
+                    }
+                    break;
+                }
+                default:
+                    break;  // nicht RT-sichere Kommandos gehen über ZMQ
+            }
+        }
+        commands_.release();
+        
+        int64_t now = time_->now();
+        for (int i = 0; i < count; i++) {
+            out[i].timestamp = now;
+        }
+        sendFiltered(out, count);
+        stats_ring_commands_.fetch_add(1);
+    }
+}
+
+// ALSA-Event (MIDI 1.0) -> UMP
 void LockFreeEngine::processMidiInEvent(snd_seq_event_t* ev) {
-    int64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
-        std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t timestamp = time_->now();
+    MidiMessage msg;
     
     switch (ev->type) {
         case SND_SEQ_EVENT_CLOCK:
-            // External Clock
-            if (clock_mode_.load() == 2) {
-                tick_counter_.fetch_add(1);
-            }
+            msg = MidiMessage(0xF8, 0, 0, timestamp);
             break;
-            
-        case SND_SEQ_EVENT_NOTEON: {
-            MidiMessage msg(0x90 | ev->data.note.channel, 
-                           ev->data.note.note, 
-                           ev->data.note.velocity,
-                           timestamp);
-            if (!midi_in_queue_.push(msg)) {
-                std::cerr << "MIDI input queue full!" << std::endl;
-            }
+        case SND_SEQ_EVENT_NOTEON:
+            msg = MidiMessage(0x90 | ev->data.note.channel, ev->data.note.note, ev->data.note.velocity, timestamp);
             break;
-        }
-            
-        case SND_SEQ_EVENT_CONTROLLER: {
-            MidiMessage msg(0xB0 | ev->data.control.channel,
-                           ev->data.control.param,
-                           ev->data.control.value,
-                           timestamp);
-            if (!midi_in_queue_.push(msg)) {
-                std::cerr << "MIDI input queue full!" << std::endl;
-            }
+        case SND_SEQ_EVENT_NOTEOFF:
+            msg = MidiMessage(0x80 | ev->data.note.channel, ev->data.note.note, ev->data.note.velocity, timestamp);
+            break;
+        case SND_SEQ_EVENT_KEYPRESS:
+            msg = MidiMessage(0xA0 | ev->data.note.channel, ev->data.note.note, ev->data.note.velocity, timestamp);
+            break;
+        case SND_SEQ_EVENT_CONTROLLER:
+            msg = MidiMessage(0xB0 | ev->data.control.channel, ev->data.control.param, ev->data.control.value, timestamp);
+            break;
+        case SND_SEQ_EVENT_PGMCHANGE:
+            msg = MidiMessage(0xC0 | ev->data.control.channel, ev->data.control.value, 0, timestamp);
+            break;
+        case SND_SEQ_EVENT_CHANPRESS:
+            msg = MidiMessage(0xD0 | ev->data.control.channel, ev->data.control.value, 0, timestamp);
+            break;
+        case SND_SEQ_EVENT_PITCHBEND: {
+            int bend = ev->data.control.value + 8192;
+            msg = MidiMessage(0xE0 | ev->data.control.channel, bend & 0x7F, (bend >> 7) & 0x7F, timestamp);
             break;
         }
-            
         case SND_SEQ_EVENT_START:
-            std::cout << "MIDI Start received" << std::endl;
+            msg = MidiMessage(0xFA, 0, 0, timestamp);
             break;
-            
         case SND_SEQ_EVENT_STOP:
-            std::cout << "MIDI Stop received" << std::endl;
+            msg = MidiMessage(0xFC, 0, 0, timestamp);
             break;
-            
         case SND_SEQ_EVENT_CONTINUE:
-            std::cout << "MIDI Continue received" << std::endl;
+            msg = MidiMessage(0xFB, 0, 0, timestamp);
             break;
+        default:
+            return;
     }
     
+    processInput(msg);
+}
+
+// Eingang (MIDI 1.0 oder 2.0): Clock, Learn, dann an Anwendung + Thru
+void LockFreeEngine::processInput(const MidiMessage& msg) {
     stats_midi_messages_.fetch_add(1);
+    
+    // Clock und Learn arbeiten auf der MIDI-1.0 Sicht (MIDI 2.0 herunterskaliert)
+    MidiMessage midi1[ump::MAX_MIDI1_MESSAGES];
+    if (ump::toMidi1(msg, midi1) == 1) {
+        uint8_t status = midi1[0].status();
+        uint8_t channel = status & 0x0F;
+        
+        switch (status & 0xF0) {
+            case 0x80:
+            case 0x90: {
+                uint8_t velocity = (status & 0xF0) == 0x90 ? midi1[0].data2() : 0;
+                if (learnInput(MidiLearn::SOURCE_NOTE, channel, midi1[0].data1(), velocity)) return;
+                break;
+            }
+            case 0xB0:
+                if (learnInput(MidiLearn::SOURCE_CC, channel, midi1[0].data1(), midi1[0].data2())) return;
+                break;
+            case 0xF0:
+                if (status == 0xF8) {
+                    // External Clock
+                    if (clock_mode_.load() == 2) {
+                        tick_counter_.fetch_add(1);
+                    }
+                    return;
+                }
+                // Transport: an Anwendung weiterreichen (kein Logging im RT-Thread)
+                if (status != 0xFA && status != 0xFB && status != 0xFC) return;
+                break;
+        }
+    }
+    
+    routeInput(msg);
 }
 
-void LockFreeEngine::processClockTick() {
-    tick_counter_.fetch_add(1);
+// 🎓 Gemappte Events werden konsumiert und direkt auf den Parameter angewendet
+bool LockFreeEngine::learnInput(MidiLearn::Source source, uint8_t channel, uint8_t number, uint8_t value) {
+    int param;
+    float target;
+    bool apply;
+    if (!learn_.process(source, channel, number, value, params_, param, target, apply)) {
+        return false;
+    }
+    if (apply) {
+        applyParameter(param, target);
+    }
+    return true;
+}
+
+// Eingehende Channel-Events: an Anwendung + optional Thru
+void LockFreeEngine::routeInput(const MidiMessage& msg) {
+    if (!midi_in_queue_.push(msg)) {
+        stats_in_overflows_.fetch_add(1);
+    }
+    if (thru_enabled_.load() && !thru_queue_.push(msg)) {
+        stats_out_overflows_.fetch_add(1);
+    }
+}
+
+void LockFreeEngine::processClockTick(int64_t tick_time) {
+    int64_t tick = tick_counter_.fetch_add(1);
+    last_tick_ns_.store(tick_time);
     
     // Master Mode: MIDI Clock senden
     if (clock_mode_.load() == 1) {
-        MidiMessage clock_msg(0xF8, 0, 0); // MIDI Clock
-        if (!midi_out_queue_.push(clock_msg)) {
-            std::cerr << "MIDI output queue full!" << std::endl;
+        MidiMessage clock_msg(0xF8, 0, 0, tick_time); // MIDI Clock
+        if (!clock_out_queue_.push(clock_msg)) {
+            stats_out_overflows_.fetch_add(1);
+        }
+    }
+    
+    // Automation exakt auf dem Tick
+    processAutomation(static_cast<double>(tick), tick_time);
+}
+
+// Song-Position in Clock-Ticks inkl. Bruchteil seit dem letzten Tick
+double LockFreeEngine::tickPosition(int64_t time) const {
+    int64_t ticks = tick_counter_.load();
+    if (!clock_running_.load() || ticks == 0) {
+        return static_cast<double>(ticks);
+    }
+    
+    double position = static_cast<double>(ticks - 1);
+    int64_t interval = tick_interval_ns_.load();
+    int64_t since_tick = time - last_tick_ns_.load();
+    if (since_tick > 0 && interval > 0) {
+        position += std::min(1.0, static_cast<double>(since_tick) / interval);
+    }
+    return position;
+}
+
+// 🌊 Control-Tick: LFOs und Automation zwischen den Clock-Ticks
+void LockFreeEngine::processControlTick(int64_t control_time) {
+    double position = tickPosition(control_time);
+    
+    MidiMessage out[ModulationEngine::MAX_LFOS];
+    int count = modulation_.process(control_time, position / 24.0, out);
+    for (int i = 0; i < count; i++) {
+        if (!clock_out_queue_.push(out[i])) {
+            stats_out_overflows_.fetch_add(1);
+        }
+    }
+    
+    if (clock_was_running_) {
+        processAutomation(position, control_time);
+    }
+    
+    processMorph(control_time);
+}
+
+// 🔀 Morph: nur geänderte CCs, gedrosselt auf Budget und freien Queue-Platz
+void LockFreeEngine::processMorph(int64_t time) {
+    int budget = std::min(morph_budget_.load(), static_cast<int>(clock_out_queue_.write_available()));
+    
+    MidiMessage out[MorphEngine::MAX_MESSAGES];
+    int count = morph_.process(params_[PARAM_MORPH].load(), time, out, budget);
+    clock_out_queue_.push(out, count);  // Budget <= freier Platz, MSB/LSB am Stück
+}
+
+// 🎚 Automation an Position (Clock-Ticks) auswerten, Loop-Länge beachten
+void LockFreeEngine::processAutomation(double tick_position, int64_t time) {
+    const double loop = static_cast<double>(loop_length_ticks_.load());
+    double position = std::fmod(tick_position, loop);
+    
+    MidiMessage out[AutomationEngine::MAX_LANES];
+    int count = automation_.process(position * AutomationEngine::SUBTICKS, time, out);
+    for (int i = 0; i < count; i++) {
+        if (!clock_out_queue_.push(out[i])) {
+            stats_out_overflows_.fetch_add(1);
         }
     }
 }
 
 void LockFreeEngine::sendMidiMessage(const MidiMessage& msg) {
+    trackNote(msg);
+    if (sink_) {
+        sink_->write(msg);
+        return;
+    }
+    if (!seq_handle_) return;
+    
+    if (ump_) {
+        sendUmp(msg);
+        return;
+    }
+    
+    // MIDI-1.0 Port: MIDI 2.0 Messages herunterskalieren, (N)RPN als CC-Folge
+    MidiMessage midi1[ump::MAX_MIDI1_MESSAGES];
+    int count = ump::toMidi1(msg, midi1);
+    for (int i = 0; i < count; i++) {
+        sendLegacy(midi1[i]);
+    }
+}
+
+// MIDI 2.0 Note On mit Velocity 0 bleibt Note On (keine Note-Off Konvention)
+void LockFreeEngine::trackNote(const MidiMessage& msg) {
+    if (msg.type() != MidiMessage::TYPE_MIDI1 && msg.type() != MidiMessage::TYPE_MIDI2) return;
+    const uint8_t opcode = msg.status() & 0xF0;
+    if (opcode != 0x80 && opcode != 0x90) return;
+    
+    const uint8_t note = msg.data1() & 0x7F;
+    uint64_t& bits = held_notes_[msg.status() & 0x0F][note >> 6];
+    const uint64_t bit = 1ULL << (note & 63);
+    if (opcode == 0x90 && (msg.type() == MidiMessage::TYPE_MIDI2 || msg.data2() > 0)) {
+        bits |= bit;
+    } else {
+        bits &= ~bit;
+    }
+}
+
+void LockFreeEngine::sendLegacy(const MidiMessage& msg) {
     snd_seq_event_t ev;
     snd_seq_ev_clear(&ev);
     
-    switch (msg.data[0] & 0xF0) {
+    const uint8_t channel = msg.status() & 0x0F;
+    switch (msg.status() & 0xF0) {
         case 0x80: // Note Off
-            snd_seq_ev_set_noteoff(&ev, msg.data[0] & 0x0F, msg.data[1], msg.data[2]);
+            snd_seq_ev_set_noteoff(&ev, channel, msg.data1(), msg.data2());
             break;
         case 0x90: // Note On
-            snd_seq_ev_set_noteon(&ev, msg.data[0] & 0x0F, msg.data[1], msg.data[2]);
+            snd_seq_ev_set_noteon(&ev, channel, msg.data1(), msg.data2());
+            break;
+        case 0xA0: // Poly Pressure
+            snd_seq_ev_set_keypress(&ev, channel, msg.data1(), msg.data2());
             break;
         case 0xB0: // Control Change
-            snd_seq_ev_set_controller(&ev, msg.data[0] & 0x0F, msg.data[1], msg.data[2]);
+            snd_seq_ev_set_controller(&ev, channel, msg.data1(), msg.data2());
+            break;
+        case 0xC0: // Program Change
+            snd_seq_ev_set_pgmchange(&ev, channel, msg.data1());
+            break;
+        case 0xD0: // Channel Pressure
+            snd_seq_ev_set_chanpress(&ev, channel, msg.data1());
+            break;
+        case 0xE0: // Pitch Bend (LSB, MSB) -> -8192..8191
+            snd_seq_ev_set_pitchbend(&ev, channel, ((msg.data2() << 7) | msg.data1()) - 8192);
             break;
         case 0xF0: // System
-            if (msg.data[0] == 0xF8) { // Clock
+            if (msg.status() == 0xF8) { // Clock
                 ev.type = SND_SEQ_EVENT_CLOCK;
             }
             break;
@@ -239,27 +1035,99 @@ void LockFreeEngine::sendMidiMessage(const MidiMessage& msg) {
         snd_seq_ev_set_source(&ev, duplex_port_);
         snd_seq_ev_set_subs(&ev);
         snd_seq_ev_set_direct(&ev);
-        snd_seq_event_output_direct(seq_handle_, &ev);
+        
+        // Kernel-Pool voll -> -EAGAIN (non-blocking), Event verwerfen
+        rt_check::Allow io(rt_check::ALLOW_IO, "alsa output");
+        if (snd_seq_event_output_direct(seq_handle_, &ev) < 0) {
+            stats_out_overflows_.fetch_add(1);
+        }
     }
 }
 
+// UMP direkt, der Kernel übersetzt für MIDI-1.0 Empfänger
+void LockFreeEngine::sendUmp(const MidiMessage& msg) {
+#ifdef SND_SEQ_CLIENT_UMP_MIDI_2_0
+    snd_seq_ump_event_t ev;
+    memset(&ev, 0, sizeof(ev));  // snd_seq_ev_clear kennt nur snd_seq_event_t
+    ev.flags |= SND_SEQ_EVENT_UMP;
+    ev.ump[0] = msg.words[0];
+    ev.ump[1] = msg.words[1];
+    
+    snd_seq_ev_set_source(&ev, duplex_port_);
+    snd_seq_ev_set_subs(&ev);
+    snd_seq_ev_set_direct(&ev);
+    
+    rt_check::Allow io(rt_check::ALLOW_IO, "alsa output");
+    if (snd_seq_ump_event_output_direct(seq_handle_, &ev) < 0) {
+        stats_out_overflows_.fetch_add(1);
+    }
+#else
+    sendLegacy(msg);
+#endif
+}
+
 void LockFreeEngine::sendMidiCC(int channel, int controller, int value) {
-    MidiMessage msg(0xB0 | channel, controller, value);
+    MidiMessage msg(0xB0 | channel, controller, value, time_->now());
     if (!midi_out_queue_.push(msg)) {
-        std::cerr << "MIDI output queue full!" << std::endl;
+        stats_out_overflows_.fetch_add(1);
+    }
+}
+
+bool LockFreeEngine::sendMidiCC14(int channel, int controller, int value) {
+    if (channel < 0 || channel > 15 || controller < 0 || controller >= 32) {
+        std::cerr << "ERROR: 14-bit CC needs controller 0..31" << std::endl;
+        return false;
+    }
+    MidiMessage out[2];
+    pushOut(out, cc14Messages(channel, controller, value, out));
+    return true;
+}
+
+bool LockFreeEngine::sendNrpn(int channel, int parameter, int value, bool hires) {
+    return sendParameter(channel, 99, parameter, value, hires);
+}
+
+bool LockFreeEngine::sendRpn(int channel, int parameter, int value, bool hires) {
+    return sendParameter(channel, 101, parameter, value, hires);
+}
+
+bool LockFreeEngine::sendParameter(int channel, uint8_t msb_cc, int parameter, int value, bool hires) {
+    if (channel < 0 || channel > 15 || parameter < 0 || parameter > 16383) {
+        std::cerr << "ERROR: Invalid (N)RPN ch:" << channel << " param:" << parameter << std::endl;
+        return false;
     }
+    MidiMessage out[4];
+    pushOut(out, parameterMessages(channel, msb_cc, parameter, value, hires, out));
+    return true;
 }
 
 void LockFreeEngine::sendMidiNote(int channel, int note, int velocity) {
     uint8_t status = velocity > 0 ? 0x90 : 0x80;
-    MidiMessage msg(status | channel, note, velocity);
+    MidiMessage msg(status | channel, note, velocity, time_->now());
     if (!midi_out_queue_.push(msg)) {
-        std::cerr << "MIDI output queue full!" << std::endl;
+        stats_out_overflows_.fetch_add(1);
+    }
+}
+
+void LockFreeEngine::sendMidi2Note(int channel, int note, uint16_t velocity) {
+    uint8_t status = (velocity > 0 ? 0x90 : 0x80) | (channel & 0x0F);
+    MidiMessage msg = MidiMessage::midi2(status, note & 0x7F, 0, static_cast<uint32_t>(velocity) << 16, time_->now());
+    if (!midi_out_queue_.push(msg)) {
+        stats_out_overflows_.fetch_add(1);
+    }
+}
+
+void LockFreeEngine::sendMidi2CC(int channel, int controller, uint32_t value) {
+    MidiMessage msg = MidiMessage::midi2(0xB0 | (channel & 0x0F), controller & 0x7F, 0, value, time_->now());
+    if (!midi_out_queue_.push(msg)) {
+        stats_out_overflows_.fetch_add(1);
     }
 }
 
 void LockFreeEngine::sendSysEx(const uint8_t* data, size_t size) {
     // Einfache SysEx Implementation
+    if (!seq_handle_) return;
+    
     snd_seq_event_t ev;
     snd_seq_ev_clear(&ev);
     ev.type = SND_SEQ_EVENT_SYSEX;
@@ -272,15 +1140,6 @@ void LockFreeEngine::sendSysEx(const uint8_t* data, size_t size) {
     snd_seq_event_output_direct(seq_handle_, &ev);
 }
 
-void LockFreeEngine::calculateInterval() {
-    double bpm = bpm_.load();
-    if (bpm < 20.0) bpm = 20.0;
-    if (bpm > 300.0) bpm = 300.0;
-    
-    int64_t ns_per_tick = static_cast<int64_t>(60'000'000'000 / (bpm * 24));
-    tick_interval_ns_.store(ns_per_tick);
-}
-
 void LockFreeEngine::lockMemory() {
     if (mlockall(MCL_CURRENT | MCL_FUTURE) == -1) {
         std::cerr << "WARNING: Cannot lock memory - " << strerror(errno) << std::endl;
@@ -291,6 +1150,11 @@ LockFreeEngine::Stats LockFreeEngine::getStats() const {
     return Stats{
         stats_clock_ticks_.load(),
         stats_midi_messages_.load(),
-        stats_max_latency_ns_.load()
+        stats_max_latency_ns_.load(),
+        stats_out_overflows_.load(),
+        stats_in_overflows_.load(),
+        stats_redundant_.load(),
+        stats_ring_commands_.load(),
+        static_cast<int64_t>(commands_.dropped())
     };
 }
\ No newline at end of file
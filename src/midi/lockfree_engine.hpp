@@ -9,23 +9,24 @@
 #include <sys/resource.h>  // Für rlimit
 #include <atomic>
 #include <chrono>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <thread>          // Für std::this_thread
 
-struct MidiMessage {
-    uint8_t data[3];
-    size_t size;
-    int64_t timestamp;
-    
-    MidiMessage() : size(0), timestamp(0) {}
-    MidiMessage(uint8_t status, uint8_t data1, uint8_t data2, int64_t ts = 0) 
-        : size(3), timestamp(ts) {
-        data[0] = status;
-        data[1] = data1;
-        data[2] = data2;
-    }
-};
+#include "automation.hpp"
+#include "command_ring.hpp"
+#include "controller_state.hpp"
+#include "midi_learn.hpp"
+#include "midi_message.hpp"
+#include "midi_sink.hpp"
+#include "modulation.hpp"
+#include "morph.hpp"
+#include "mpe.hpp"
+#include "rt_swap.hpp"
+#include "tempo_map.hpp"
+#include "time_source.hpp"
+#include "ump.hpp"
 
 class LockFreeEngine {
 public:
@@ -38,31 +39,116 @@ public:
     // Engine Control
     bool start();
     void stop();
+    // 🛑 Beenden mit Aufräumen: Threads stoppen, alle Queues ausgeben,
+    // gehaltene Noten mit Note Off lösen. Gibt die Zahl gelöster Noten zurück.
+    int shutdown();
+    // SCHED_FIFO für die Engine-Threads (Clock = priority, Out -1, In -2),
+    // cpu >= 0 pinnt alle drei. Vor start() setzen, 0 = normaler Scheduler.
+    void setRealtime(int priority, int cpu = -1);
     
     // 🎵 Clock Control
+    // Tempo-Änderungen greifen ab dem nächsten Clock-Tick (Tick-Grenze, kein Phasensprung)
     void setBpm(double bpm);
+    void rampBpm(double bpm, int64_t ticks);               // Lineare Rampe vom aktuellen Tempo
+    void setTempoMap(std::vector<TempoSegment> segments);  // Absolute Song-Ticks (24 PPQN)
     void startClock();
     void stopClock();
     void setClockMode(int mode);
     
+    // 🌊 Modulation (LFOs im Clock-Thread)
+    bool setLfo(int index, const LfoConfig& config);
+    bool clearLfo(int index);
+    
+    // 🎚 Automation (Wiedergabe im Clock-Thread, Loop-Länge in Clock-Ticks)
+    void setLoopLength(int64_t ticks);
+    bool setAutomationLane(int lane, int channel, int controller);
+    bool setAutomationPoints(int lane, std::vector<AutomationPoint> points);
+    bool clearAutomation(int lane);
+    void armAutomation(int lane, bool armed);
+    void writeAutomation(int lane, float value);   // Live-Wert 0..1, wird bei Record aufgezeichnet
+    int applyAutomationTouches();                  // Touches aus dem Kommando-Ring aufzeichnen (Editor-Thread)
+    bool automationArmed() const { return automation_.armed(); }
+    
+    // 🔀 Preset-Morph: Position ist PARAM_MORPH (z.B. per MIDI Learn auf einen Fader)
+    bool setMorphTargets(std::vector<MorphTarget> targets);
+    bool storeMorphSnapshot(int slot, std::vector<float> values);  // 0 = A, 1 = B, Werte 0..1
+    void setMorphBudget(int messages_per_tick);                     // Ausgabe-Budget pro Control-Tick
+    
+    // 🎹 MPE (Lower Zone). Werte normalisiert: bend -1..1, pressure/timbre 0..1.
+    // Voice = frei wählbare ID, z.B. Touch-Slot. MCM wird bei start() gesendet.
+    void mpeConfigure(int member_channels, int bend_range = 48);
+    void mpeNoteOn(int voice, int note, int velocity, float bend = 0.0f, float timbre = 0.5f);
+    void mpeExpression(int voice, float bend, float pressure, float timbre);
+    void mpeNoteOff(int voice, int velocity = 0);
+    
+    // 🎓 Parameter & MIDI Learn (Zuordnung wird im MIDI-In Thread angewendet)
+    void setParameter(int param, float value);
+    float getParameter(int param) const;
+    void armLearn(int param, float min = 0.0f, float max = 1.0f, bool pickup = true);
+    void cancelLearn();
+    MidiLearn& midiLearn() { return learn_; }
+    
+    // 🔀 Routing
+    bool connectOutput(const char* address);   // z.B. "14:0" oder "Midi Through"
+    bool connectInput(const char* address);
+    void setThru(bool enabled);
+    
     // MIDI IO
     void sendMidiCC(int channel, int controller, int value);
+    // 🎚 14-bit: MSB (controller 0..31) + LSB (controller + 32), Wert 0..16383.
+    // Redundante MSBs und bereits aktive NRPN/RPN-Adressen filtert der Output-Thread.
+    bool sendMidiCC14(int channel, int controller, int value);
+    bool sendNrpn(int channel, int parameter, int value, bool hires = true);
+    bool sendRpn(int channel, int parameter, int value, bool hires = true);
     void sendMidiNote(int channel, int note, int velocity);
+    // 🎼 MIDI 2.0: 16-bit Velocity (0 = Note Off) / 32-bit Controller.
+    // Ohne UMP-Port werden sie am Ausgang auf MIDI 1.0 herunterskaliert.
+    void sendMidi2Note(int channel, int note, uint16_t velocity);
+    void sendMidi2CC(int channel, int controller, uint32_t value);
+    bool umpActive() const { return ump_; }
     void sendSysEx(const uint8_t* data, size_t size);
     
+    // ⚡ Shared-Memory Kommando-Ring anlegen (nur wenn Engine gestoppt).
+    // Der Output-Thread liest ihn direkt und wird per Futex-Doorbell geweckt.
+    bool attachCommandRing(const char* name = command_ring::DEFAULT_NAME);
+    
+    // 🧪 Zeitquelle / Ausgabe injizieren (nur wenn Engine gestoppt)
+    void setTimeSource(TimeSource* source);
+    void setSink(MidiSink* sink);
+    
+    // 🧪 Offline-Render: Clock läuft synchron im aufrufenden Thread,
+    // so schnell wie die Zeitquelle erlaubt. Gibt gerenderte Ticks zurück (-1 wenn Engine läuft).
+    int64_t renderOffline(int64_t duration_ns);
+    
     // Statistik
     struct Stats {
         int64_t clock_ticks;
         int64_t midi_messages;
         int64_t max_latency_ns;
+        int64_t out_queue_overflows;
+        int64_t in_queue_overflows;
+        int64_t redundant_controllers;  // vom Output-Thread verworfen
+        int64_t ring_commands;          // aus dem Kommando-Ring ausgeführt
+        int64_t ring_dropped;           // Ring voll (Producer-Seite gezählt)
     };
     
     Stats getStats() const;
+    
+    // 📡 Zustand für Telemetrie (beliebiger Thread, nur Atomics)
+    double getBpm() const { return bpm_.load(); }
+    bool clockRunning() const { return clock_running_.load(); }
+    int64_t tickCount() const { return tick_counter_.load(); }
+    uint32_t transportSeq() const { return transport_seq_.load(); }  // +1 pro Start/Stop
+    // Freie Slots der API-Out-Queue - nur aus dem API-Thread (Producer) aussagekräftig
+    size_t outputSpace() const { return midi_out_queue_.write_available(); }
+    // Eingehende MIDI-Messages inkl. Transport (FA/FB/FC). Genau ein Consumer-Thread.
+    bool popInput(MidiMessage& msg) { return midi_in_queue_.pop(msg); }
 
 private:
     // ALSA
     snd_seq_t* seq_handle_;
     int duplex_port_;
+    bool ump_{false};   // Client als MIDI 2.0 (UMP) registriert, sonst MIDI 1.0 Events
     
     // 🚀 Echtzeit-Threads
     pthread_t clock_thread_;
@@ -70,22 +156,91 @@ private:
     pthread_t midi_out_thread_;
     std::atomic<bool> running_{false};
     
+    // ⏱ Zeit & Ausgabe
+    SteadyTimeSource steady_time_;
+    TimeSource* time_;
+    MidiSink* sink_;
+    
+    // Clock-Zustand (gehört dem Clock-Thread bzw. renderOffline)
+    int64_t next_tick_ns_{0};
+    int64_t next_control_ns_{0};
+    bool clock_was_running_{false};
+    
+    // ⏱ Tempo: Deadlines relativ zum Anker (Tick, Zeit) aus der Map integriert
+    const TempoMap* tempo_map_{nullptr};
+    size_t tempo_cursor_{0};
+    int64_t next_tick_index_{0};
+    int64_t anchor_tick_{0};
+    int64_t anchor_ns_{0};
+    FixedNs anchor_offset_{0};      // tickTime(anchor_tick_)
+    double tempo_override_{0.0};    // > 0: konstantes Tempo aus MIDI Learn statt Map
+    FixedNs override_period_{0};
+    uint32_t tempo_request_seen_{0};
+    
+    // Tempo-Map: Editor-Seite unter Mutex, RT-Seite über RtSwap
+    std::mutex tempo_mutex_;
+    std::vector<TempoSegment> tempo_segments_;
+    RtSwap<TempoMap> tempo_;
+    // RT-sichere Tempo-Anfrage (MIDI Learn im MIDI-In Thread, keine Allokation)
+    std::atomic<double> tempo_request_bpm_{120.0};
+    std::atomic<uint32_t> tempo_request_seq_{0};
+    
+    // Control-Rate für Modulation (unabhängig vom MIDI Clock)
+    static constexpr int64_t CONTROL_INTERVAL_NS = 2'000'000; // 500 Hz
+    ModulationEngine modulation_;
+    AutomationEngine automation_;
+    MorphEngine morph_;
+    std::atomic<int> morph_budget_{16};  // 8000 Messages/s bei 500 Hz
+    
     // 🔄 Lock-free Queues - KORRIGIERT
     static constexpr size_t QUEUE_SIZE = 1024;
-    boost::lockfree::spsc_queue<MidiMessage, boost::lockfree::capacity<QUEUE_SIZE>> midi_out_queue_;
-    boost::lockfree::spsc_queue<MidiMessage, boost::lockfree::capacity<QUEUE_SIZE>> midi_in_queue_;
+    typedef boost::lockfree::spsc_queue<MidiMessage, boost::lockfree::capacity<QUEUE_SIZE>> MidiQueue;
+    MidiQueue midi_out_queue_;
+    MidiQueue midi_in_queue_;
+    // Ein Producer pro Queue: Clock-Thread und MIDI-In (Thru) getrennt von der API
+    MidiQueue clock_out_queue_;
+    MidiQueue thru_queue_;
+    
+    // Controller-Zustand auf dem Draht (gehört dem Output-Thread)
+    ControllerState controllers_;
+    std::atomic<bool> controllers_reset_{false};
+    
+    // Kommando-Ring aus Python (Consumer = Output-Thread)
+    command_ring::Consumer commands_;
     
     // 🎵 Atomic State
     std::atomic<double> bpm_{120.0};
     std::atomic<bool> clock_running_{false};
+    std::atomic<uint32_t> transport_seq_{0};
     std::atomic<int> clock_mode_{0}; // 0=internal, 1=master, 2=slave
-    std::atomic<int64_t> tick_interval_ns_{2083333}; // 120 BPM
+    std::atomic<int64_t> tick_interval_ns_{20833333}; // 120 BPM
     std::atomic<int64_t> tick_counter_{0};
+    std::atomic<int64_t> last_tick_ns_{0};
+    std::atomic<int64_t> loop_length_ticks_{384}; // 4 Takte à 4/4
+    std::atomic<bool> thru_enabled_{false};
+    
+    // 🎛 Parameter (normalisiert 0..1)
+    std::atomic<float> params_[MAX_PARAMS];
+    MidiLearn learn_;
+    
+    // 🎹 MPE - gehört dem API-Thread, Ausgabe über midi_out_queue_
+    MpeZone mpe_;
+    
+    // Gehaltene Noten auf dem Draht, 128 Bit pro Kanal (gehört dem Output-Thread)
+    uint64_t held_notes_[16][2] = {};
+    
+    // Echtzeit-Konfiguration der Threads
+    int rt_priority_{0};
+    int rt_cpu_{-1};
     
     // 📊 Atomic Statistics
     std::atomic<int64_t> stats_clock_ticks_{0};
     std::atomic<int64_t> stats_midi_messages_{0};
     std::atomic<int64_t> stats_max_latency_ns_{0};
+    std::atomic<int64_t> stats_out_overflows_{0};
+    std::atomic<int64_t> stats_in_overflows_{0};
+    std::atomic<int64_t> stats_redundant_{0};
+    std::atomic<int64_t> stats_ring_commands_{0};
     
     // Thread Functions
     static void* clockThread(void* arg);
@@ -93,10 +248,31 @@ private:
     static void* midiOutThread(void* arg);
     
     // Internal
-    void calculateInterval();
-    void processClockTick();
+    void publishTempo(std::vector<TempoSegment> segments);
+    void anchorTempo(int64_t tick, int64_t time);
+    int64_t tickDeadline(int64_t tick);
+    int64_t clockStep(int64_t now);
+    void processClockTick(int64_t tick_time);
+    void processControlTick(int64_t control_time);
+    void processAutomation(double tick_position, int64_t time);
+    uint32_t automationPosition(uint32_t& loop_subticks) const;
+    void processMorph(int64_t time);
+    double tickPosition(int64_t time) const;
+    void drainOutput();
+    void drainQueue(MidiQueue& queue);
+    void drainCommands();
+    void sendFiltered(const MidiMessage* messages, int count);
     void processMidiInEvent(snd_seq_event_t* ev);
+    void processInput(const MidiMessage& msg);
+    void routeInput(const MidiMessage& msg);
+    bool learnInput(MidiLearn::Source source, uint8_t channel, uint8_t number, uint8_t value);
+    void applyParameter(int param, float value);
+    void pushOut(const MidiMessage* messages, int count);
+    bool sendParameter(int channel, uint8_t msb_cc, int parameter, int value, bool hires);
     void sendMidiMessage(const MidiMessage& msg);
+    void trackNote(const MidiMessage& msg);
+    void sendLegacy(const MidiMessage& msg);
+    void sendUmp(const MidiMessage& msg);
     
     // 🔧 Echtzeit-Helper
     bool configureRealtime();
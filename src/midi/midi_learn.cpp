@@ -0,0 +1,110 @@
+#include "midi_learn.hpp"
+#include <cmath>
+
+MidiLearn::MidiLearn() {
+    for (int i = 0; i < TABLE_SIZE; i++) {
+        table_[i].store(0, std::memory_order_relaxed);
+    }
+    for (int i = 0; i < MAX_PARAMS; i++) {
+        picked_up_[i].store(false, std::memory_order_relaxed);
+        last_input_[i] = -1.0f;
+    }
+}
+
+void MidiLearn::arm(int param, uint8_t min, uint8_t max, bool pickup) {
+    if (param < 0 || param >= MAX_PARAMS) return;
+    
+    Mapping mapping;
+    mapping.param = static_cast<uint8_t>(param);
+    mapping.min = min;
+    mapping.max = max;
+    mapping.pickup = pickup;
+    armed_entry_.store(encode(mapping));
+    armed_.store(param);
+}
+
+void MidiLearn::cancel() {
+    armed_.store(-1);
+}
+
+bool MidiLearn::setMapping(Source source, int channel, int number, const Mapping& mapping) {
+    if (source >= SOURCE_COUNT || mapping.param >= MAX_PARAMS) return false;
+    table_[index(source, channel, number)].store(encode(mapping));
+    invalidatePickup(mapping.param);
+    return true;
+}
+
+void MidiLearn::clearMapping(Source source, int channel, int number) {
+    if (source >= SOURCE_COUNT) return;
+    table_[index(source, channel, number)].store(0);
+}
+
+bool MidiLearn::getMapping(Source source, int channel, int number, Mapping& mapping) const {
+    if (source >= SOURCE_COUNT) return false;
+    
+    uint32_t entry = table_[index(source, channel, number)].load();
+    if (!(entry & VALID)) return false;
+    
+    mapping.param = entry & 0xFF;
+    mapping.min = (entry >> 8) & 0xFF;
+    mapping.max = (entry >> 16) & 0xFF;
+    mapping.pickup = entry & PICKUP;
+    return true;
+}
+
+void MidiLearn::clearAll() {
+    for (int i = 0; i < TABLE_SIZE; i++) {
+        table_[i].store(0);
+    }
+}
+
+void MidiLearn::invalidatePickup(int param) {
+    if (param < 0 || param >= MAX_PARAMS) return;
+    picked_up_[param].store(false, std::memory_order_relaxed);
+}
+
+bool MidiLearn::process(Source source, uint8_t channel, uint8_t number, uint8_t value,
+                        const std::atomic<float>* params, int& param, float& out, bool& apply) {
+    const int slot = index(source, channel, number);
+    apply = false;
+    
+    // Learn: erster bewegter Controller / erste Note übernimmt den Parameter
+    if (armed_.load(std::memory_order_relaxed) >= 0) {
+        int armed = armed_.exchange(-1);
+        if (armed >= 0) {
+            // Weitere Quellen für denselben Parameter bleiben bestehen
+            table_[slot].store(armed_entry_.load());
+            picked_up_[armed].store(false, std::memory_order_relaxed);
+            last_input_[armed] = -1.0f;
+        }
+    }
+    
+    uint32_t entry = table_[slot].load(std::memory_order_acquire);
+    if (!(entry & VALID)) return false;
+    
+    param = entry & 0xFF;
+    const float min = ((entry >> 8) & 0xFF) / 255.0f;
+    const float max = ((entry >> 16) & 0xFF) / 255.0f;
+    
+    // Noten: Note-On = max, Note-Off (oder Velocity 0) = min
+    float input = source == SOURCE_NOTE ? (value > 0 ? 1.0f : 0.0f) : value / 127.0f;
+    out = min + input * (max - min);
+    
+    if ((entry & PICKUP) && source == SOURCE_CC && !picked_up_[param].load(std::memory_order_relaxed)) {
+        float current = params[param].load(std::memory_order_relaxed);
+        float last = last_input_[param];
+        last_input_[param] = out;
+        
+        // Nahe genug oder seit dem letzten Event über den aktuellen Wert gelaufen
+        bool near = std::fabs(out - current) <= 1.0f / 127.0f;
+        bool crossed = last >= 0.0f && ((last - current) * (out - current) <= 0.0f);
+        if (!near && !crossed) {
+            return true;
+        }
+        picked_up_[param].store(true, std::memory_order_relaxed);
+    }
+    
+    last_input_[param] = out;
+    apply = true;
+    return true;
+}
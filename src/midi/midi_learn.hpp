@@ -0,0 +1,79 @@
+#ifndef MIDI_LEARN_HPP
+#define MIDI_LEARN_HPP
+
+#include <atomic>
+#include <cstdint>
+
+// 🎛 Engine-Parameter (normalisiert 0..1)
+enum EngineParam : uint8_t {
+    PARAM_TEMPO = 0,      // 20..300 BPM
+    PARAM_SWING = 1,
+    PARAM_MORPH = 2,      // Preset-Morph A..B
+    PARAM_FADER_BASE = 3, // PARAM_FADER_BASE + n = Fader n
+    MAX_PARAMS = 64
+};
+
+// 🎓 MIDI Learn: Controller/Note -> Parameter
+//
+// Flache Tabelle [Quelle][Kanal][Nummer] aus atomaren 32-bit Einträgen.
+// Der MIDI-In Thread macht pro Event genau einen Load - keine Map, keine
+// Allokation. Soft-Takeover (Pickup): ein Controller übernimmt erst, wenn
+// er den aktuellen Parameterwert erreicht oder überquert.
+class MidiLearn {
+public:
+    enum Source : uint8_t {
+        SOURCE_CC = 0,
+        SOURCE_NOTE = 1,
+        SOURCE_COUNT = 2
+    };
+    
+    struct Mapping {
+        uint8_t param;
+        uint8_t min = 0;      // Zielbereich in 1/255
+        uint8_t max = 255;
+        bool pickup = true;
+    };
+    
+    MidiLearn();
+    
+    // API-Thread
+    void arm(int param, uint8_t min = 0, uint8_t max = 255, bool pickup = true);
+    void cancel();
+    int armedParam() const { return armed_.load(); }
+    bool setMapping(Source source, int channel, int number, const Mapping& mapping);
+    void clearMapping(Source source, int channel, int number);
+    bool getMapping(Source source, int channel, int number, Mapping& mapping) const;
+    void clearAll();
+    
+    // Parameter wurde anderweitig geändert (UI, IPC) -> Controller muss neu abholen
+    void invalidatePickup(int param);
+    
+    // MIDI-In Thread: true wenn das Event gemappt (und damit konsumiert) ist.
+    // apply = true wenn value auf param geschrieben werden soll.
+    bool process(Source source, uint8_t channel, uint8_t number, uint8_t value,
+                 const std::atomic<float>* params, int& param, float& out, bool& apply);
+
+private:
+    static constexpr uint32_t VALID = 1u << 31;
+    static constexpr uint32_t PICKUP = 1u << 24;
+    static constexpr int TABLE_SIZE = SOURCE_COUNT * 16 * 128;
+    
+    static int index(Source source, int channel, int number) {
+        return (source * 16 + (channel & 0x0F)) * 128 + (number & 0x7F);
+    }
+    
+    static uint32_t encode(const Mapping& m) {
+        return VALID | (m.pickup ? PICKUP : 0) | (uint32_t(m.max) << 16) | (uint32_t(m.min) << 8) | m.param;
+    }
+    
+    alignas(64) std::atomic<uint32_t> table_[TABLE_SIZE];
+    
+    std::atomic<int> armed_{-1};
+    std::atomic<uint32_t> armed_entry_{0};
+    
+    // Pickup-Zustand pro Parameter (nur MIDI-In Thread, außer dem Invalidate-Flag)
+    std::atomic<bool> picked_up_[MAX_PARAMS];
+    float last_input_[MAX_PARAMS];
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef MIDI_MESSAGE_HPP
+#define MIDI_MESSAGE_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+// 🎼 Internes Event: Universal MIDI Packet (max. 64 bit) + Zeitstempel = 16 Bytes
+//
+// words[0] = [Typ:4][Gruppe:4][Status:8][Index/Daten 1:8][Index/Daten 2:8]
+//   TYPE_SYSTEM  System Realtime/Common (F8, FA..FC, ...)
+//   TYPE_MIDI1   MIDI 1.0 Channel Voice, Daten 7 bit
+//   TYPE_MIDI2   MIDI 2.0 Channel Voice, words[1] = Wert (16 bit Velocity / 32 bit)
+// Der MIDI-1.0 Konstruktor erzeugt TYPE_SYSTEM/TYPE_MIDI1. Übersetzung
+// MIDI 1.0 <-> 2.0 an den Ports: siehe ump.hpp.
+struct MidiMessage {
+    enum Type : uint8_t {
+        TYPE_UTILITY = 0x0,
+        TYPE_SYSTEM = 0x1,
+        TYPE_MIDI1 = 0x2,
+        TYPE_MIDI2 = 0x4
+    };
+
+    uint32_t words[2];
+    int64_t timestamp;
+
+    MidiMessage() : words{0, 0}, timestamp(0) {}
+    MidiMessage(uint8_t status, uint8_t data1, uint8_t data2, int64_t ts = 0)
+        : words{pack(status >= 0xF0 ? TYPE_SYSTEM : TYPE_MIDI1, status, data1 & 0x7F, data2 & 0x7F), 0},
+          timestamp(ts) {}
+
+    // MIDI 2.0 Channel Voice: status = Opcode | Kanal, index1/index2 = Note/Controller/Bank/...
+    static MidiMessage midi2(uint8_t status, uint8_t index1, uint8_t index2, uint32_t value, int64_t ts = 0) {
+        MidiMessage msg;
+        msg.words[0] = pack(TYPE_MIDI2, status, index1, index2);
+        msg.words[1] = value;
+        msg.timestamp = ts;
+        return msg;
+    }
+
+    uint8_t type() const { return words[0] >> 28; }
+    uint8_t group() const { return (words[0] >> 24) & 0x0F; }
+    uint8_t status() const { return (words[0] >> 16) & 0xFF; }
+    uint8_t data1() const { return (words[0] >> 8) & 0xFF; }
+    uint8_t data2() const { return words[0] & 0xFF; }
+    int wordCount() const { return type() == TYPE_MIDI2 ? 2 : 1; }
+
+private:
+    static constexpr uint32_t pack(uint32_t type, uint32_t status, uint32_t data1, uint32_t data2) {
+        return type << 28 | status << 16 | data1 << 8 | data2;
+    }
+};
+
+static_assert(sizeof(MidiMessage) == 16, "MidiMessage soll 16 Bytes bleiben (Queue-Durchsatz)");
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef MIDI_SINK_HPP
+#define MIDI_SINK_HPP
+
+#include "midi_message.hpp"
+#include <cstdint>
+#include <vector>
+
+// 🎯 Ziel für ausgehende Events. Ohne Sink schreibt die Engine direkt nach ALSA.
+class MidiSink {
+public:
+    virtual ~MidiSink() = default;
+    virtual void write(const MidiMessage& msg) = 0;
+};
+
+// 🧪 In-Memory Sink für Offline-Render und Tests ohne Hardware.
+// Kapazität wird vorab reserviert - write() alloziert nie.
+class MemorySink : public MidiSink {
+public:
+    explicit MemorySink(size_t capacity) {
+        events_.reserve(capacity);
+    }
+    
+    void write(const MidiMessage& msg) override {
+        if (events_.size() < events_.capacity()) {
+            events_.push_back(msg);
+        } else {
+            dropped_++;
+        }
+    }
+    
+    const std::vector<MidiMessage>& events() const { return events_; }
+    uint64_t dropped() const { return dropped_; }
+    
+    void clear() {
+        events_.clear();
+        dropped_ = 0;
+    }
+    
+    // FNV-1a über UMP-Worte + Timestamps: zwei Renders sind bit-identisch wenn der Hash gleich ist
+    uint64_t hash() const {
+        uint64_t h = 0xcbf29ce484222325ULL;
+        auto mix = [&h](uint64_t v, int bytes) {
+            for (int i = 0; i < bytes; i++) {
+                h ^= (v >> (i * 8)) & 0xFF;
+                h *= 0x100000001b3ULL;
+            }
+        };
+        for (const auto& msg : events_) {
+            for (int i = 0; i < msg.wordCount(); i++) mix(msg.words[i], 4);
+            mix(static_cast<uint64_t>(msg.timestamp), 8);
+        }
+        return h;
+    }
+
+private:
+    std::vector<MidiMessage> events_;
+    uint64_t dropped_ = 0;
+};
+
+#endif
@@ -0,0 +1,177 @@
+#include "modulation.hpp"
+#include <cmath>
+#include <cstring>
+
+ModulationEngine::ModulationEngine() : active_mask_(0), last_now_ns_(-1) {
+    for (int i = 0; i < MAX_LFOS; i++) {
+        phase_[i] = 0.0f;
+        rate_[i] = 0.0f;
+        depth_[i] = 0.0f;
+        center_[i] = 0.5f;
+        offset_[i] = 0.0f;
+        shape_[i] = 0;
+        sync_[i] = 0.0f;
+        held_[i] = 0.0f;
+        value_[i] = 0.0f;
+        random_state_[i] = 0x9E3779B9u * (i + 1);  // deterministisch pro LFO
+        last_sent_[i] = -1;
+        target_[i] = ModTarget::NONE;
+        channel_[i] = 0;
+        controller_[i] = 0;
+    }
+}
+
+bool ModulationEngine::configure(int index, const LfoConfig& config) {
+    if (index < 0 || index >= MAX_LFOS) return false;
+    return commands_.push(Command{index, true, config});
+}
+
+bool ModulationEngine::disable(int index) {
+    if (index < 0 || index >= MAX_LFOS) return false;
+    return commands_.push(Command{index, false, LfoConfig()});
+}
+
+void ModulationEngine::applyCommands() {
+    Command cmd;
+    while (commands_.pop(cmd)) {
+        int i = cmd.index;
+        uint32_t bit = 1u << i;
+        
+        if (!cmd.enabled || cmd.config.target == ModTarget::NONE) {
+            active_mask_ &= ~bit;
+            continue;
+        }
+        
+        const LfoConfig& c = cmd.config;
+        rate_[i] = c.rate;
+        depth_[i] = c.depth;
+        center_[i] = c.center;
+        offset_[i] = c.phase_offset - std::floor(c.phase_offset);
+        shape_[i] = static_cast<int32_t>(c.shape);
+        sync_[i] = c.tempo_sync ? 1.0f : 0.0f;
+        target_[i] = c.target;
+        channel_[i] = c.channel & 0x0F;
+        controller_[i] = c.controller & 0x7F;
+        last_sent_[i] = -1;  // neues Ziel -> ersten Wert sicher senden
+        
+        if (!(active_mask_ & bit)) {
+            phase_[i] = 0.0f;
+            held_[i] = 0.0f;
+        }
+        active_mask_ |= bit;
+    }
+}
+
+// GCC Vektor-Erweiterungen: NEON auf dem Pi, SSE auf x86
+namespace {
+
+typedef float v4f __attribute__((vector_size(16)));
+typedef int32_t v4i __attribute__((vector_size(16)));
+
+const v4f ZERO = {0.0f, 0.0f, 0.0f, 0.0f};
+const v4f ONE = {1.0f, 1.0f, 1.0f, 1.0f};
+
+inline v4f vabs(v4f v) {
+    return (v4f)((v4i)v & 0x7FFFFFFF);
+}
+
+// mask: -1 (true) / 0 (false) pro Lane
+inline v4f select(v4i mask, v4f a, v4f b) {
+    return (v4f)((mask & (v4i)a) | (~mask & (v4i)b));
+}
+
+static_assert(ModulationEngine::MAX_LFOS % 4 == 0, "LFO-Anzahl muss Vielfaches der Vektorbreite sein");
+
+} // namespace
+
+// xorshift32 -> [-1, 1)
+float ModulationEngine::nextRandom(int i) {
+    uint32_t x = random_state_[i];
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    random_state_[i] = x;
+    return static_cast<float>(x >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+int ModulationEngine::process(int64_t now_ns, double beat_position, MidiMessage* out) {
+    applyCommands();
+    
+    float dt = last_now_ns_ < 0 ? 0.0f : static_cast<float>(now_ns - last_now_ns_) * 1e-9f;
+    last_now_ns_ = now_ns;
+    
+    if (!active_mask_) return 0;
+    
+    // Zufallsformen: Sprung bei Phasen-Wrap (S&H) bzw. Schritt pro Tick (Random Walk)
+    for (int i = 0; i < MAX_LFOS; i++) {
+        if (!(active_mask_ & (1u << i))) continue;
+        
+        float previous = phase_[i];
+        double cycles = sync_[i] > 0.5f
+            ? beat_position * rate_[i]          // tempo-sync: Phase folgt der Song-Position
+            : previous + rate_[i] * dt;
+        float next = static_cast<float>(cycles - std::floor(cycles));
+        
+        if (shape_[i] == static_cast<int32_t>(LfoShape::SAMPLE_HOLD) && next < previous) {
+            held_[i] = nextRandom(i);
+        } else if (shape_[i] == static_cast<int32_t>(LfoShape::RANDOM_WALK)) {
+            float step = std::fmin(1.0f, rate_[i] * dt * 4.0f);
+            held_[i] = std::fmax(-1.0f, std::fmin(1.0f, held_[i] + nextRandom(i) * step));
+        }
+        phase_[i] = next;
+    }
+    
+    // 🚀 Batch: 4 LFOs pro SIMD-Vektor, alle Formen berechnen, pro Lane auswählen
+    for (int i = 0; i < MAX_LFOS; i += 4) {
+        v4f phase, offset, center, depth, held;
+        v4i shape;
+        std::memcpy(&phase, &phase_[i], sizeof(v4f));
+        std::memcpy(&offset, &offset_[i], sizeof(v4f));
+        std::memcpy(&center, &center_[i], sizeof(v4f));
+        std::memcpy(&depth, &depth_[i], sizeof(v4f));
+        std::memcpy(&held, &held_[i], sizeof(v4f));
+        std::memcpy(&shape, &shape_[i], sizeof(v4i));
+        
+        v4f x = phase + offset;
+        x = select(x >= 1.0f, x - 1.0f, x);
+        
+        // Parabel-Sinus mit Korrektur (Fehler < 0.1%)
+        v4f t = 2.0f * x - 1.0f;
+        v4f s = 4.0f * t * (1.0f - vabs(t));
+        v4f sine = -(0.225f * (s * vabs(s) - s) + s);
+        
+        v4f tri = 1.0f - 4.0f * vabs(x - 0.5f);
+        v4f saw = 2.0f * x - 1.0f;
+        v4f square = select(x < 0.5f, ONE, -ONE);
+        
+        v4f raw = select(shape == static_cast<int32_t>(LfoShape::SINE), sine,
+                  select(shape == static_cast<int32_t>(LfoShape::TRIANGLE), tri,
+                  select(shape == static_cast<int32_t>(LfoShape::SAW), saw,
+                  select(shape == static_cast<int32_t>(LfoShape::SQUARE), square, held))));
+        
+        v4f v = center + 0.5f * depth * raw;
+        v = select(v < 0.0f, ZERO, v);
+        v = select(v > 1.0f, ONE, v);
+        std::memcpy(&value_[i], &v, sizeof(v4f));
+    }
+    
+    // Quantisieren + nur Änderungen senden
+    int count = 0;
+    for (int i = 0; i < MAX_LFOS; i++) {
+        if (!(active_mask_ & (1u << i))) continue;
+        
+        if (target_[i] == ModTarget::CC) {
+            int32_t q = static_cast<int32_t>(value_[i] * 127.0f + 0.5f);
+            if (q == last_sent_[i]) continue;
+            last_sent_[i] = q;
+            out[count++] = MidiMessage(0xB0 | channel_[i], controller_[i], q, now_ns);
+        } else if (target_[i] == ModTarget::PITCH_BEND) {
+            int32_t q = static_cast<int32_t>(value_[i] * 16383.0f + 0.5f);
+            if (q == last_sent_[i]) continue;
+            last_sent_[i] = q;
+            out[count++] = MidiMessage(0xE0 | channel_[i], q & 0x7F, (q >> 7) & 0x7F, now_ns);
+        }
+    }
+    
+    return count;
+}
@@ -0,0 +1,87 @@
+#ifndef MODULATION_HPP
+#define MODULATION_HPP
+
+#include "midi_message.hpp"
+#include <boost/lockfree/spsc_queue.hpp>
+#include <cstdint>
+
+enum class LfoShape : uint8_t {
+    SINE = 0,
+    TRIANGLE,
+    SAW,
+    SQUARE,
+    SAMPLE_HOLD,
+    RANDOM_WALK
+};
+
+enum class ModTarget : uint8_t {
+    NONE = 0,
+    CC,          // 7-bit Controller
+    PITCH_BEND   // 14-bit
+};
+
+struct LfoConfig {
+    LfoShape shape = LfoShape::SINE;
+    bool tempo_sync = false;
+    float rate = 1.0f;          // Hz (frei) oder Zyklen pro Beat (sync)
+    float depth = 1.0f;         // 0..1, Hub um center
+    float center = 0.5f;        // 0..1
+    float phase_offset = 0.0f;  // 0..1
+    ModTarget target = ModTarget::NONE;
+    uint8_t channel = 0;
+    uint8_t controller = 1;
+};
+
+// 🌊 Control-Rate LFOs für CC / Pitch Bend
+//
+// Konfiguration kommt über eine SPSC-Queue vom API-Thread, process() läuft
+// im Clock-Thread. Zustand liegt als Struct-of-Arrays vor, damit alle LFOs
+// pro Control-Tick in einem SIMD-Durchlauf (4 Lanes) berechnet werden.
+// Gesendet wird nur, wenn sich der quantisierte Wert ändert.
+class ModulationEngine {
+public:
+    static constexpr int MAX_LFOS = 16;
+    
+    ModulationEngine();
+    
+    // API-Thread
+    bool configure(int index, const LfoConfig& config);
+    bool disable(int index);
+    
+    // Clock-Thread: schreibt max. MAX_LFOS Messages nach out, gibt Anzahl zurück
+    int process(int64_t now_ns, double beat_position, MidiMessage* out);
+
+private:
+    struct Command {
+        int index;
+        bool enabled;
+        LfoConfig config;
+    };
+    
+    void applyCommands();
+    float nextRandom(int i);
+    
+    boost::lockfree::spsc_queue<Command, boost::lockfree::capacity<64>> commands_;
+    
+    // Struct-of-Arrays (nur Clock-Thread)
+    alignas(64) float phase_[MAX_LFOS];
+    alignas(64) float rate_[MAX_LFOS];
+    alignas(64) float depth_[MAX_LFOS];
+    alignas(64) float center_[MAX_LFOS];
+    alignas(64) float offset_[MAX_LFOS];
+    alignas(64) int32_t shape_[MAX_LFOS];    // LfoShape
+    alignas(64) float sync_[MAX_LFOS];       // 1.0 = tempo sync
+    alignas(64) float held_[MAX_LFOS];       // S&H / Random Walk Zustand
+    alignas(64) float value_[MAX_LFOS];      // Ausgabe 0..1
+    
+    uint32_t random_state_[MAX_LFOS];
+    int32_t last_sent_[MAX_LFOS];
+    ModTarget target_[MAX_LFOS];
+    uint8_t channel_[MAX_LFOS];
+    uint8_t controller_[MAX_LFOS];
+    uint32_t active_mask_;
+    
+    int64_t last_now_ns_;
+};
+
+#endif
@@ -0,0 +1,150 @@
+#include "morph.hpp"
+#include <algorithm>
+#include <cstring>
+
+// GCC Vektor-Erweiterungen: NEON auf dem Pi, SSE auf x86
+namespace {
+
+typedef float v4f __attribute__((vector_size(16)));
+typedef int32_t v4i __attribute__((vector_size(16)));
+
+static_assert(MorphEngine::MAX_TARGETS % 4 == 0, "Ziel-Anzahl muss Vielfaches der Vektorbreite sein");
+
+} // namespace
+
+MorphEngine::MorphEngine() : stored_{false, false}, generation_(0), set_(nullptr), generation_seen_(0),
+                             last_position_(-1.0f), pending_(false), scan_(0) {
+    for (int i = 0; i < MAX_TARGETS; i++) {
+        value_[i] = 0;
+        last_sent_[i] = -1;
+    }
+}
+
+bool MorphEngine::setTargets(std::vector<MorphTarget> targets) {
+    if (targets.size() > static_cast<size_t>(MAX_TARGETS)) return false;
+    for (const MorphTarget& t : targets) {
+        // LSB liegt auf controller + 32
+        if (t.hires && (t.controller & 0x7F) >= 32) return false;
+    }
+
+    std::lock_guard<std::mutex> lock(edit_mutex_);
+    targets_ = std::move(targets);
+    snapshots_[0].assign(targets_.size(), 0.0f);
+    snapshots_[1].assign(targets_.size(), 0.0f);
+    stored_[0] = stored_[1] = false;
+    generation_++;
+    publish();
+    return true;
+}
+
+bool MorphEngine::storeSnapshot(int slot, std::vector<float> values) {
+    if (slot < 0 || slot > 1) return false;
+
+    std::lock_guard<std::mutex> lock(edit_mutex_);
+    if (values.size() != targets_.size()) return false;
+    for (float& v : values) {
+        v = std::min(1.0f, std::max(0.0f, v));
+    }
+    snapshots_[slot] = std::move(values);
+    stored_[slot] = true;
+    publish();
+    return true;
+}
+
+size_t MorphEngine::targetCount() const {
+    std::lock_guard<std::mutex> lock(edit_mutex_);
+    return targets_.size();
+}
+
+// Editor-Mutex muss gehalten sein
+void MorphEngine::publish() {
+    int count = static_cast<int>(targets_.size());
+    int padded = (count + 3) & ~3;
+
+    MorphSet* set = new MorphSet{count, padded, generation_, stored_[0] && stored_[1],
+                                 snapshots_[0], snapshots_[1],
+                                 std::vector<float>(padded, 0.0f), {}, {}, {}};
+    set->a.resize(padded, 0.0f);
+    set->b.resize(padded, 0.0f);
+    set->status.reserve(count);
+    set->controller.reserve(count);
+    set->hires.reserve(count);
+    for (int i = 0; i < count; i++) {
+        const MorphTarget& t = targets_[i];
+        set->scale[i] = t.hires ? 16383.0f : 127.0f;
+        set->status.push_back(0xB0 | (t.channel & 0x0F));
+        set->controller.push_back(t.controller & 0x7F);
+        set->hires.push_back(t.hires ? 1 : 0);
+    }
+    sets_.publish(set);
+}
+
+int MorphEngine::process(float position, int64_t now_ns, MidiMessage* out, int budget) {
+    const MorphSet* set = sets_.acquire();
+    if (set != set_) {
+        set_ = set;
+        if (set && set->generation != generation_seen_) {
+            // Neue Ziele: gesendete Werte gehören zu den alten, nichts offen
+            generation_seen_ = set->generation;
+            scan_ = 0;
+            pending_ = false;
+            for (int i = 0; i < MAX_TARGETS; i++) {
+                last_sent_[i] = -1;
+            }
+        }
+        // Nur neue Snapshot-Daten: kein Senden erzwingen, die nächste Bewegung nimmt sie mit
+    }
+
+    const bool moved = position != last_position_;
+    last_position_ = position;
+    if (!set_ || set_->count == 0 || !set_->ready) {
+        pending_ = false;
+        return 0;
+    }
+    if (!moved && !pending_) return 0;
+
+    // 🚀 4 Ziele pro Vektor: a + (b - a) * x, quantisiert auf 7/14 bit
+    const float* a = set_->a.data();
+    const float* b = set_->b.data();
+    const float* scale = set_->scale.data();
+    const v4f x = {position, position, position, position};
+    for (int i = 0; i < set_->padded; i += 4) {
+        v4f va, vb, vs;
+        std::memcpy(&va, a + i, sizeof(v4f));
+        std::memcpy(&vb, b + i, sizeof(v4f));
+        std::memcpy(&vs, scale + i, sizeof(v4f));
+
+        v4i q = __builtin_convertvector((va + (vb - va) * x) * vs + 0.5f, v4i);
+        std::memcpy(&value_[i], &q, sizeof(v4i));
+    }
+
+    // Diff + Ausgabe ab scan_, bis das Budget erschöpft ist
+    budget = std::min(budget, MAX_MESSAGES);
+    const int count = set_->count;
+    int written = 0;
+    pending_ = false;
+    for (int n = 0; n < count; n++) {
+        int i = scan_ + n < count ? scan_ + n : scan_ + n - count;
+        int32_t v = value_[i];
+        if (v == last_sent_[i]) continue;
+
+        bool hires = set_->hires[i];
+        if (written + (hires ? 2 : 1) > budget) {
+            pending_ = true;
+            scan_ = i;
+            break;
+        }
+
+        uint8_t status = set_->status[i];
+        uint8_t controller = set_->controller[i];
+        if (hires) {
+            out[written++] = MidiMessage(status, controller, (v >> 7) & 0x7F, now_ns);
+            out[written++] = MidiMessage(status, controller + 32, v & 0x7F, now_ns);
+        } else {
+            out[written++] = MidiMessage(status, controller, v & 0x7F, now_ns);
+        }
+        last_sent_[i] = v;
+    }
+
+    return written;
+}
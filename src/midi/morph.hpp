@@ -0,0 +1,81 @@
+#ifndef MORPH_HPP
+#define MORPH_HPP
+
+#include "midi_message.hpp"
+#include "rt_swap.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Morph-Ziel: CC auf einem Kanal, optional 14-bit (MSB controller, LSB controller + 32)
+struct MorphTarget {
+    uint8_t channel;
+    uint8_t controller;
+    bool hires;
+};
+
+// 🔀 Preset-Morph zwischen zwei Snapshots A/B
+//
+// Editor-Seite hält Ziele und Snapshots, veröffentlicht bei jeder Änderung
+// einen unveränderlichen Satz zusammenhängender Arrays über RtSwap.
+// Clock-Thread: pro Control-Tick SIMD-Interpolation + Quantisierung aller
+// Ziele, dann Diff gegen den zuletzt gesendeten Wert. Gesendet wird nur,
+// was sich geändert hat - max. `budget` Messages pro Tick, Rest im nächsten
+// Tick (Round-Robin, damit hintere Ziele nicht verhungern).
+//
+// Ausgabe nur bei Bewegung der Position und erst, wenn A und B gespeichert
+// sind: Ziele setzen oder Snapshots speichern allein sendet nichts, sonst
+// überschreibt das Konfigurieren die Einstellungen am Synth.
+class MorphEngine {
+public:
+    static constexpr int MAX_TARGETS = 512;
+    static constexpr int MAX_MESSAGES = 64;  // Obergrenze Budget pro Aufruf
+
+    MorphEngine();
+
+    // Editor-Thread. Neue Ziele verwerfen beide Snapshots.
+    bool setTargets(std::vector<MorphTarget> targets);
+    bool storeSnapshot(int slot, std::vector<float> values);   // slot 0 = A, 1 = B
+    size_t targetCount() const;
+
+    // Clock-Thread: position 0 = A, 1 = B
+    int process(float position, int64_t now_ns, MidiMessage* out, int budget);
+
+private:
+    struct MorphSet {
+        int count;                      // Ziele
+        int padded;                     // auf Vektorbreite aufgerundet
+        uint32_t generation;            // wechselt mit den Zielen, nicht mit Snapshots
+        bool ready;                     // A und B gespeichert
+        std::vector<float> a;
+        std::vector<float> b;
+        std::vector<float> scale;       // 127 / 16383, 0 für Padding
+        std::vector<uint8_t> status;    // 0xB0 | channel
+        std::vector<uint8_t> controller;
+        std::vector<uint8_t> hires;
+    };
+
+    void publish();
+
+    // Editor
+    mutable std::mutex edit_mutex_;
+    std::vector<MorphTarget> targets_;
+    std::vector<float> snapshots_[2];
+    bool stored_[2];
+    uint32_t generation_;
+
+    // Übergabe
+    RtSwap<MorphSet> sets_;
+
+    // Clock-Thread
+    const MorphSet* set_;
+    uint32_t generation_seen_;
+    float last_position_;
+    bool pending_;                      // Budget erschöpft -> Änderungen offen
+    int scan_;                          // Round-Robin Startindex
+    alignas(64) int32_t value_[MAX_TARGETS];
+    alignas(64) int32_t last_sent_[MAX_TARGETS];
+};
+
+#endif
@@ -0,0 +1,155 @@
+#include "mpe.hpp"
+#include <algorithm>
+
+namespace {
+
+int clamp(int v, int lo, int hi) {
+    return std::min(hi, std::max(lo, v));
+}
+
+int toBend(float bend) {  // -1..1 -> 0..16383
+    return clamp(static_cast<int>((bend + 1.0f) * 8191.5f + 0.5f), 0, 16383);
+}
+
+int to7(float v) {  // 0..1 -> 0..127
+    return clamp(static_cast<int>(v * 127.0f + 0.5f), 0, 127);
+}
+
+} // namespace
+
+MpeZone::MpeZone() : member_channels_(0), bend_range_(48), clock_(0) {
+    for (auto& ch : channels_) {
+        ch = Channel{-1, 0, 0, -1, -1, -1};
+    }
+    for (auto& v : voice_channel_) {
+        v = -1;
+    }
+}
+
+// Laufende Noten vorher mit allNotesOff() beenden
+void MpeZone::configure(int member_channels, int bend_range) {
+    member_channels_ = clamp(member_channels, 0, 15);
+    bend_range_ = clamp(bend_range, 1, 96);
+    for (auto& ch : channels_) {
+        ch = Channel{-1, 0, 0, -1, -1, -1};
+    }
+    for (auto& v : voice_channel_) {
+        v = -1;
+    }
+}
+
+// MPE Configuration Message: RPN 6 auf dem Manager-Kanal, dazu RPN 0
+// (Pitch-Bend-Range) für die Zone. Reihenfolge laut MPE-Spezifikation.
+int MpeZone::configuration(MidiMessage* out) const {
+    int count = 0;
+    out[count++] = MidiMessage(0xB0, 101, 0);
+    out[count++] = MidiMessage(0xB0, 100, 6);
+    out[count++] = MidiMessage(0xB0, 6, member_channels_);
+    if (member_channels_ > 0) {
+        out[count++] = MidiMessage(0xB1, 101, 0);
+        out[count++] = MidiMessage(0xB1, 100, 0);
+        out[count++] = MidiMessage(0xB1, 6, bend_range_);
+        // RPN zurücksetzen (Null-Parameter)
+        out[count++] = MidiMessage(0xB1, 101, 127);
+        out[count++] = MidiMessage(0xB1, 100, 127);
+    }
+    return count;
+}
+
+// Kanal-Vergabe: freier Kanal mit ältestem Release, sonst älteste aktive Note
+int MpeZone::allocate() {
+    int best_free = -1;
+    int best_busy = -1;
+    
+    for (int ch = 1; ch <= member_channels_; ch++) {
+        const Channel& c = channels_[ch];
+        if (c.voice < 0) {
+            if (best_free < 0 || c.last_used < channels_[best_free].last_used) best_free = ch;
+        } else {
+            if (best_busy < 0 || c.last_used < channels_[best_busy].last_used) best_busy = ch;
+        }
+    }
+    
+    return best_free >= 0 ? best_free : best_busy;
+}
+
+int MpeZone::noteOn(int voice, int note, int velocity, float bend, float timbre, MidiMessage* out) {
+    if (!enabled() || voice < 0 || voice >= MAX_VOICES) return 0;
+    
+    int count = 0;
+    
+    // Voice spielt schon -> erst beenden (Retrigger)
+    if (voice_channel_[voice] >= 0) {
+        count += noteOff(voice, 0, out);
+    }
+    
+    int ch = allocate();
+    Channel& c = channels_[ch];
+    
+    // Stehlen: laufende Note auf dem Kanal beenden
+    if (c.voice >= 0) {
+        out[count++] = MidiMessage(0x80 | ch, c.note, 0);
+        voice_channel_[c.voice] = -1;
+    }
+    
+    c.voice = voice;
+    c.note = clamp(note, 0, 127);
+    c.last_used = ++clock_;
+    voice_channel_[voice] = static_cast<int8_t>(ch);
+    
+    // Expression vor Note-On, damit der Synth mit den richtigen Werten startet
+    count += expressionFor(ch, bend, 0.0f, timbre, out + count, true);
+    out[count++] = MidiMessage(0x90 | ch, c.note, clamp(velocity, 1, 127));
+    return count;
+}
+
+int MpeZone::expression(int voice, float bend, float pressure, float timbre, MidiMessage* out) {
+    if (voice < 0 || voice >= MAX_VOICES || voice_channel_[voice] < 0) return 0;
+    return expressionFor(voice_channel_[voice], bend, pressure, timbre, out, false);
+}
+
+int MpeZone::expressionFor(int ch, float bend, float pressure, float timbre, MidiMessage* out, bool force) {
+    Channel& c = channels_[ch];
+    int count = 0;
+    
+    int b = toBend(bend);
+    if (force || b != c.bend) {
+        out[count++] = MidiMessage(0xE0 | ch, b & 0x7F, (b >> 7) & 0x7F);
+        c.bend = static_cast<int16_t>(b);
+    }
+    
+    int p = to7(pressure);
+    if (force || p != c.pressure) {
+        out[count++] = MidiMessage(0xD0 | ch, p, 0);
+        c.pressure = static_cast<int8_t>(p);
+    }
+    
+    int t = to7(timbre);
+    if (force || t != c.timbre) {
+        out[count++] = MidiMessage(0xB0 | ch, 74, t);
+        c.timbre = static_cast<int8_t>(t);
+    }
+    
+    return count;
+}
+
+int MpeZone::noteOff(int voice, int velocity, MidiMessage* out) {
+    if (voice < 0 || voice >= MAX_VOICES || voice_channel_[voice] < 0) return 0;
+    
+    int ch = voice_channel_[voice];
+    Channel& c = channels_[ch];
+    out[0] = MidiMessage(0x80 | ch, c.note, clamp(velocity, 0, 127));
+    
+    c.voice = -1;
+    c.last_used = ++clock_;  // Release-Zeit: Kanal klingt evtl. noch aus
+    voice_channel_[voice] = -1;
+    return 1;
+}
+
+int MpeZone::allNotesOff(MidiMessage* out, int max) {
+    int count = 0;
+    for (int voice = 0; voice < MAX_VOICES && count < max; voice++) {
+        count += noteOff(voice, 0, out + count);
+    }
+    return count;
+}
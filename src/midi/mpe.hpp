@@ -0,0 +1,54 @@
+#ifndef MPE_HPP
+#define MPE_HPP
+
+#include "midi_message.hpp"
+#include <cstdint>
+
+// 🎹 MPE Lower Zone: Manager-Kanal 0, Member-Kanäle 1..N
+//
+// Jede Note (Voice, z.B. ein Touch-Slot) bekommt einen eigenen Member-Kanal.
+// Freie Kanäle werden in LRU-Reihenfolge vergeben, sind alle belegt, wird
+// die am längsten laufende Note gestohlen. Per-Note Expression (Pitch Bend,
+// Channel Pressure, CC74) geht auf den Kanal der Voice und wird nur bei
+// Wertänderung gesendet. Feste Arrays, keine Allokation pro Event.
+class MpeZone {
+public:
+    static constexpr int MAX_VOICES = 32;
+    static constexpr int MAX_MESSAGES = 8;  // max. Messages pro Aufruf
+    
+    MpeZone();
+    
+    void configure(int member_channels, int bend_range);
+    
+    // Schreiben nach out (max. MAX_MESSAGES) und geben die Anzahl zurück
+    int configuration(MidiMessage* out) const;  // MCM + Pitch-Bend-Range
+    
+    int noteOn(int voice, int note, int velocity, float bend, float timbre, MidiMessage* out);
+    int expression(int voice, float bend, float pressure, float timbre, MidiMessage* out);
+    int noteOff(int voice, int velocity, MidiMessage* out);
+    int allNotesOff(MidiMessage* out, int max);
+    
+    bool enabled() const { return member_channels_ > 0; }
+    int memberChannels() const { return member_channels_; }
+
+private:
+    struct Channel {
+        int voice;          // -1 = frei
+        int note;
+        uint64_t last_used; // LRU-Zeitstempel (Zähler)
+        int16_t bend;       // zuletzt gesendete Werte
+        int8_t pressure;
+        int8_t timbre;
+    };
+    
+    int allocate();
+    int expressionFor(int ch, float bend, float pressure, float timbre, MidiMessage* out, bool force);
+    
+    int member_channels_;
+    int bend_range_;
+    uint64_t clock_;
+    Channel channels_[16];
+    int8_t voice_channel_[MAX_VOICES];  // Voice -> Kanal, -1 = keine Note
+};
+
+#endif
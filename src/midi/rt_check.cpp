@@ -0,0 +1,250 @@
+// rt_check.cpp - Interposer für RT-Safety Checks (nur mit -DTAUWERK_RT_CHECK)
+//
+// malloc & Co. werden über die glibc __libc_* Einstiegspunkte weitergereicht,
+// alles andere über dlsym(RTLD_NEXT). Der Thread-Zustand liegt in statischem
+// TLS, damit die Hooks selbst nie allozieren.
+#include "rt_check.hpp"
+
+#ifdef TAUWERK_RT_CHECK
+
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/select.h>
+#include <time.h>
+#include <unistd.h>
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void __libc_free(void* ptr);
+void* __libc_calloc(size_t n, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+}
+
+namespace {
+
+struct ThreadState {
+    const char* name;
+    unsigned allowed;       // rt_check::AllowMask der offenen Allow-Scopes
+    bool realtime;
+    bool reporting;
+};
+
+__thread ThreadState tls_state __attribute__((tls_model("initial-exec"))) = {nullptr, 0, false, false};
+
+std::atomic<int64_t> g_counts[rt_check::VIOLATION_KINDS];
+std::atomic<int> g_traces_left{32};
+bool g_trap = false;
+
+const char* const KIND_NAMES[rt_check::VIOLATION_KINDS] = {"malloc", "free", "mutex", "syscall"};
+
+// Echte Funktionen - einmalig aufgelöst
+template <typename Fn>
+Fn real(Fn& slot, const char* name) {
+    if (!slot) {
+        slot = reinterpret_cast<Fn>(dlsym(RTLD_NEXT, name));
+    }
+    return slot;
+}
+
+int (*real_mutex_lock)(pthread_mutex_t*) = nullptr;
+ssize_t (*real_write)(int, const void*, size_t) = nullptr;
+ssize_t (*real_read)(int, void*, size_t) = nullptr;
+int (*real_poll)(pollfd*, nfds_t, int) = nullptr;
+int (*real_select)(int, fd_set*, fd_set*, fd_set*, timeval*) = nullptr;
+int (*real_nanosleep)(const timespec*, timespec*) = nullptr;
+int (*real_clock_nanosleep)(clockid_t, int, const timespec*, timespec*) = nullptr;
+int (*real_usleep)(useconds_t) = nullptr;
+size_t (*real_fwrite)(const void*, size_t, size_t, FILE*) = nullptr;
+int (*real_fflush)(FILE*) = nullptr;
+
+// allow = Maske, die diesen Aufruf freigibt (0 = nie erlaubt: malloc, Mutex, stdio)
+inline bool checking(unsigned allow) {
+    return tls_state.realtime && !(tls_state.allowed & allow) && !tls_state.reporting;
+}
+
+void report(rt_check::Violation kind, const char* what) {
+    tls_state.reporting = true;
+    int saved_errno = errno;
+    
+    g_counts[kind].fetch_add(1, std::memory_order_relaxed);
+    
+    if (g_trap) {
+        raise(SIGTRAP);
+    }
+    
+    // Nur die ersten Reports mit Stacktrace, danach nur zählen
+    if (g_traces_left.fetch_sub(1, std::memory_order_relaxed) > 0) {
+        char line[160];
+        int len = snprintf(line, sizeof(line), "RT VIOLATION [%s] %s in thread '%s'\n",
+                           KIND_NAMES[kind], what, tls_state.name ? tls_state.name : "?");
+        real(real_write, "write")(STDERR_FILENO, line, len);
+        
+        void* frames[32];
+        int depth = backtrace(frames, 32);
+        backtrace_symbols_fd(frames, depth, STDERR_FILENO);
+    }
+    
+    errno = saved_errno;
+    tls_state.reporting = false;
+}
+
+inline void check(rt_check::Violation kind, const char* what, unsigned allow = 0) {
+    if (checking(allow)) report(kind, what);
+}
+
+struct Init {
+    Init() {
+        const char* mode = getenv("TAUWERK_RT_CHECK");
+        g_trap = mode && strcmp(mode, "trap") == 0;
+        
+        real(real_mutex_lock, "pthread_mutex_lock");
+        real(real_write, "write");
+        real(real_read, "read");
+        real(real_poll, "poll");
+        real(real_select, "select");
+        real(real_nanosleep, "nanosleep");
+        real(real_clock_nanosleep, "clock_nanosleep");
+        real(real_usleep, "usleep");
+        real(real_fwrite, "fwrite");
+        real(real_fflush, "fflush");
+        
+        // libgcc vorab laden - backtrace() alloziert sonst beim ersten Report
+        void* warmup[2];
+        backtrace(warmup, 2);
+    }
+} g_init;
+
+} // namespace
+
+namespace rt_check {
+
+bool enabled() { return true; }
+
+void enterRealtime(const char* thread_name) {
+    tls_state.name = thread_name;
+    tls_state.realtime = true;
+}
+
+void leaveRealtime() {
+    tls_state.realtime = false;
+}
+
+unsigned pushAllow(unsigned mask) {
+    unsigned previous = tls_state.allowed;
+    tls_state.allowed |= mask;
+    return previous;
+}
+
+void popAllow(unsigned previous) { tls_state.allowed = previous; }
+
+int64_t count(Violation kind) {
+    return g_counts[kind].load(std::memory_order_relaxed);
+}
+
+void printSummary() {
+    fprintf(stderr, "RT check: malloc=%ld free=%ld mutex=%ld syscall=%ld\n",
+            static_cast<long>(count(ALLOC)), static_cast<long>(count(FREE)),
+            static_cast<long>(count(MUTEX)), static_cast<long>(count(SYSCALL)));
+}
+
+} // namespace rt_check
+
+// 🪝 Interposer
+extern "C" {
+
+void* malloc(size_t size) {
+    check(rt_check::ALLOC, "malloc");
+    return __libc_malloc(size);
+}
+
+void free(void* ptr) {
+    if (ptr) check(rt_check::FREE, "free");
+    __libc_free(ptr);
+}
+
+void* calloc(size_t n, size_t size) {
+    check(rt_check::ALLOC, "calloc");
+    return __libc_calloc(n, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    check(rt_check::ALLOC, "realloc");
+    return __libc_realloc(ptr, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    check(rt_check::ALLOC, "aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size) {
+    check(rt_check::ALLOC, "posix_memalign");
+    void* ptr = __libc_memalign(alignment, size);
+    if (!ptr) return ENOMEM;
+    *out = ptr;
+    return 0;
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) {
+    check(rt_check::MUTEX, "pthread_mutex_lock");
+    return real(real_mutex_lock, "pthread_mutex_lock")(mutex);
+}
+
+ssize_t write(int fd, const void* buf, size_t count) {
+    check(rt_check::SYSCALL, "write", rt_check::ALLOW_IO);
+    return real(real_write, "write")(fd, buf, count);
+}
+
+ssize_t read(int fd, void* buf, size_t count) {
+    check(rt_check::SYSCALL, "read", rt_check::ALLOW_IO);
+    return real(real_read, "read")(fd, buf, count);
+}
+
+int poll(pollfd* fds, nfds_t nfds, int timeout) {
+    check(rt_check::SYSCALL, "poll", rt_check::ALLOW_WAIT);
+    return real(real_poll, "poll")(fds, nfds, timeout);
+}
+
+int select(int nfds, fd_set* r, fd_set* w, fd_set* e, timeval* timeout) {
+    check(rt_check::SYSCALL, "select", rt_check::ALLOW_WAIT);
+    return real(real_select, "select")(nfds, r, w, e, timeout);
+}
+
+int nanosleep(const timespec* req, timespec* rem) {
+    check(rt_check::SYSCALL, "nanosleep", rt_check::ALLOW_WAIT);
+    return real(real_nanosleep, "nanosleep")(req, rem);
+}
+
+int clock_nanosleep(clockid_t clock, int flags, const timespec* req, timespec* rem) {
+    check(rt_check::SYSCALL, "clock_nanosleep", rt_check::ALLOW_WAIT);
+    return real(real_clock_nanosleep, "clock_nanosleep")(clock, flags, req, rem);
+}
+
+int usleep(useconds_t usec) {
+    check(rt_check::SYSCALL, "usleep", rt_check::ALLOW_WAIT);
+    return real(real_usleep, "usleep")(usec);
+}
+
+// std::cout / std::cerr landen hier (libstdc++ schreibt über stdio)
+size_t fwrite(const void* ptr, size_t size, size_t n, FILE* stream) {
+    check(rt_check::SYSCALL, "fwrite");
+    return real(real_fwrite, "fwrite")(ptr, size, n, stream);
+}
+
+int fflush(FILE* stream) {
+    check(rt_check::SYSCALL, "fflush");
+    return real(real_fflush, "fflush")(stream);
+}
+
+} // extern "C"
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef RT_CHECK_HPP
+#define RT_CHECK_HPP
+
+#include <cstdint>
+
+// 🛡 RT-Safety Checker
+//
+// Nur aktiv mit -DTAUWERK_RT_CHECK (make bench RT_CHECK=1), sonst No-Ops.
+// Threads die enterRealtime() aufrufen melden malloc/free, Mutex-Locks,
+// stdio und blockierende Syscalls mit Stacktrace auf stderr.
+// TAUWERK_RT_CHECK=trap im Environment löst stattdessen SIGTRAP aus (für gdb).
+namespace rt_check {
+
+enum Violation {
+    ALLOC = 0,
+    FREE,
+    MUTEX,
+    SYSCALL,
+    VIOLATION_KINDS
+};
+
+// Was ein Allow-Scope erlaubt. Bewusst fein: ein ALSA-Write erlaubt nur
+// read/write, malloc oder Mutexe in alsa-lib werden weiter gemeldet.
+enum AllowMask : unsigned {
+    ALLOW_IO = 1u << 0,         // read, write (ALSA Sequencer-fd)
+    ALLOW_WAIT = 1u << 1,       // poll, select, nanosleep & Co.
+};
+
+#ifdef TAUWERK_RT_CHECK
+bool enabled();
+void enterRealtime(const char* thread_name);
+void leaveRealtime();
+unsigned pushAllow(unsigned mask);      // liefert die vorherige Maske
+void popAllow(unsigned previous);
+int64_t count(Violation kind);
+void printSummary();
+#else
+inline bool enabled() { return false; }
+inline void enterRealtime(const char*) {}
+inline void leaveRealtime() {}
+inline unsigned pushAllow(unsigned) { return 0; }
+inline void popAllow(unsigned) {}
+inline int64_t count(Violation) { return 0; }
+inline void printSummary() {}
+#endif
+
+// Bewusster Wartepunkt oder I/O im RT-Thread, z.B.
+//   rt_check::Allow io(rt_check::ALLOW_IO, "alsa output");
+class Allow {
+public:
+    Allow(unsigned mask, const char* reason) : previous_(pushAllow(mask)) {
+        (void)reason;
+    }
+    ~Allow() { popAllow(previous_); }
+    
+    Allow(const Allow&) = delete;
+    Allow& operator=(const Allow&) = delete;
+
+private:
+    unsigned previous_;
+};
+
+} // namespace rt_check
+
+#endif
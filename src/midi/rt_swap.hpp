@@ -0,0 +1,62 @@
+#ifndef RT_SWAP_HPP
+#define RT_SWAP_HPP
+
+#include <boost/lockfree/spsc_queue.hpp>
+#include <atomic>
+#include <cstddef>
+
+// 🔄 Atomarer Buffer-Tausch Editor -> RT-Thread
+//
+// Editor-Thread: publish() übergibt einen fertig gebauten Buffer,
+// collect() gibt vom RT-Thread zurückgereichte Buffer frei.
+// RT-Thread: acquire() holt wait-free die neueste Version. delete passiert
+// nie im RT-Thread - alte Buffer gehen über eine SPSC-Queue zurück.
+template <typename T, size_t RETIRE_CAPACITY = 16>
+class RtSwap {
+public:
+    RtSwap() = default;
+    RtSwap(const RtSwap&) = delete;
+    RtSwap& operator=(const RtSwap&) = delete;
+    
+    // Nur aufrufen wenn kein RT-Thread mehr liest
+    ~RtSwap() {
+        collect();
+        delete pending_.load();
+        delete current_;
+    }
+    
+    // Editor-Thread
+    void publish(T* next) {
+        collect();
+        // Vom RT-Thread nie gesehen -> direkt freigeben
+        delete pending_.exchange(next, std::memory_order_acq_rel);
+    }
+    
+    void collect() {
+        T* retired;
+        while (retired_.pop(retired)) {
+            delete retired;
+        }
+    }
+    
+    // RT-Thread
+    const T* acquire() {
+        if (pending_.load(std::memory_order_relaxed) && retired_.write_available() > 0) {
+            T* next = pending_.exchange(nullptr, std::memory_order_acq_rel);
+            if (next) {
+                if (current_) retired_.push(current_);
+                current_ = next;
+            }
+        }
+        return current_;
+    }
+    
+    const T* current() const { return current_; }
+
+private:
+    std::atomic<T*> pending_{nullptr};
+    T* current_ = nullptr;  // gehört dem RT-Thread
+    boost::lockfree::spsc_queue<T*, boost::lockfree::capacity<RETIRE_CAPACITY>> retired_;
+};
+
+#endif
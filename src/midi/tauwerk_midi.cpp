@@ -0,0 +1,256 @@
+// tauwerk_midi.cpp - MIDI-Engine als Daemon (systemd Type=notify)
+//
+// Aufruf:
+//   bin/tauwerk_midi [--config /home/tauwerk/config/hardware.ini]
+//
+// Ablauf: Konfiguration ([midi] in hardware.ini) -> Speicher sperren und
+// vorfaulten -> ALSA, Kommando-Ring, IPC, Telemetrie -> READY=1.
+// SIGTERM/SIGINT: IPC schließen, Queues ausgeben, gehaltene Noten lösen.
+// Kaltstart-Zeiten (ab main) werden geloggt und als STATUS= gemeldet,
+// die Zeit bis zum ersten Clock-Tick nur mit autostart.
+
+#include "ipc_server.hpp"
+#include "lockfree_engine.hpp"
+#include "telemetry.hpp"
+#include <csignal>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <malloc.h>
+#include <sstream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+struct MidiConfig {
+    std::string outputs;            // Komma-getrennt, z.B. "14:0,Midi Through"
+    std::string inputs;
+    int clock_mode = 0;             // internal / master / slave
+    double bpm = 120.0;
+    bool thru = false;
+    bool autostart = false;         // Clock direkt starten
+    int loop_bars = 4;              // Automation-Loop (Sequencer-Loop)
+    int beats_per_bar = 4;
+    int rt_priority = 80;
+    int rt_cpu = -1;
+    bool command_ring = true;
+    int telemetry_ms = 50;
+};
+
+int64_t monotonicNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+}
+
+std::string trim(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    return s.substr(begin, s.find_last_not_of(" \t\r") - begin + 1);
+}
+
+bool parseBool(const std::string& value) {
+    return value == "1" || value == "true" || value == "yes" || value == "on";
+}
+
+// Nur [midi] - die übrigen Abschnitte gehören GPIO-Treiber und App
+bool loadConfig(const char* path, MidiConfig& config) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+
+    std::string line;
+    bool in_midi = false;
+    while (std::getline(file, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == ';' || line[0] == '#') continue;
+        if (line[0] == '[') {
+            in_midi = line == "[midi]";
+            continue;
+        }
+        size_t eq = line.find('=');
+        if (!in_midi || eq == std::string::npos) continue;
+
+        std::string key = trim(line.substr(0, eq));
+        std::string value = trim(line.substr(eq + 1));
+        try {
+            if (key == "output") config.outputs = value;
+            else if (key == "input") config.inputs = value;
+            else if (key == "clock_mode") config.clock_mode = value == "master" ? 1 : value == "slave" ? 2 : 0;
+            else if (key == "bpm") config.bpm = std::stod(value);
+            else if (key == "thru") config.thru = parseBool(value);
+            else if (key == "autostart") config.autostart = parseBool(value);
+            else if (key == "loop_bars") config.loop_bars = std::stoi(value);
+            else if (key == "beats_per_bar") config.beats_per_bar = std::stoi(value);
+            else if (key == "rt_priority") config.rt_priority = std::stoi(value);
+            else if (key == "rt_cpu") config.rt_cpu = std::stoi(value);
+            else if (key == "command_ring") config.command_ring = parseBool(value);
+            else if (key == "telemetry_ms") config.telemetry_ms = std::stoi(value);
+            else std::cerr << "⚠️  Unknown [midi] key: " << key << std::endl;
+        } catch (const std::exception&) {
+            std::cerr << "⚠️  Invalid value for [midi] " << key << ": " << value << std::endl;
+        }
+    }
+    return true;
+}
+
+// sd_notify ohne libsystemd: ein Datagramm an $NOTIFY_SOCKET
+void notifySystemd(const std::string& state) {
+    const char* path = getenv("NOTIFY_SOCKET");
+    if (!path || (path[0] != '/' && path[0] != '@')) return;
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    size_t len = strlen(path);
+    if (len >= sizeof(addr.sun_path)) return;
+    memcpy(addr.sun_path, path, len);
+    if (path[0] == '@') addr.sun_path[0] = '\0';   // Abstract Namespace
+
+    int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return;
+    sendto(fd, state.data(), state.size(), MSG_NOSIGNAL,
+           reinterpret_cast<sockaddr*>(&addr), offsetof(sockaddr_un, sun_path) + len);
+    close(fd);
+}
+
+// 🔒 Heap nie an den Kernel zurückgeben und einmal anfassen: nach mlockall
+// liegen diese Seiten dauerhaft im RAM, spätere Allokationen faulten nicht
+void prefaultHeap(size_t bytes) {
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+    char* block = static_cast<char*>(malloc(bytes));
+    if (!block) return;
+    for (size_t i = 0; i < bytes; i += 4096) {
+        block[i] = 0;
+    }
+    free(block);
+}
+
+void prefaultStack() {
+    volatile char stack[256 * 1024];
+    for (size_t i = 0; i < sizeof(stack); i += 4096) {
+        stack[i] = 0;
+    }
+}
+
+void connectAll(LockFreeEngine& engine, const std::string& list, bool output) {
+    std::stringstream ss(list);
+    std::string address;
+    while (std::getline(ss, address, ',')) {
+        address = trim(address);
+        if (address.empty()) continue;
+        bool ok = output ? engine.connectOutput(address.c_str()) : engine.connectInput(address.c_str());
+        std::cout << (ok ? "🔗 " : "❌ ") << (output ? "Output " : "Input ") << address << std::endl;
+    }
+}
+
+double msSince(int64_t start) {
+    return (monotonicNs() - start) / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int64_t t_main = monotonicNs();
+    const char* config_path = "/home/tauwerk/config/hardware.ini";
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--config") && i + 1 < argc) config_path = argv[++i];
+    }
+
+    // Signale vor allen Threads blockieren (vererbt sich), main wartet per sigtimedwait
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    MidiConfig config;
+    if (!loadConfig(config_path, config)) {
+        std::cerr << "⚠️  Cannot read " << config_path << " - using defaults" << std::endl;
+    }
+
+    // initialize() sperrt den Speicher (mlockall MCL_CURRENT | MCL_FUTURE)
+    prefaultHeap(8 * 1024 * 1024);
+    LockFreeEngine engine;
+    if (!engine.initialize()) {
+        return 1;
+    }
+    prefaultStack();
+    const double t_init = msSince(t_main);
+
+    engine.setClockMode(config.clock_mode);
+    engine.setBpm(config.bpm);
+    engine.setLoopLength(static_cast<int64_t>(config.loop_bars) * config.beats_per_bar * 24);
+    engine.setThru(config.thru);
+    engine.setRealtime(config.rt_priority, config.rt_cpu);
+    connectAll(engine, config.outputs, true);
+    connectAll(engine, config.inputs, false);
+    if (config.command_ring && !engine.attachCommandRing()) {
+        std::cerr << "❌ Command ring not available" << std::endl;
+        return 1;
+    }
+
+    if (!engine.start()) {
+        return 1;
+    }
+    // Ohne Kommando-Socket nicht READY melden: RT-Threads sauber beenden
+    // (Drain + Note Offs) und mit Fehler raus, systemd startet neu
+    IPCServer ipc(engine);
+    Telemetry telemetry(engine);
+    if (!ipc.start() || !telemetry.start("ipc:///tmp/tauwerk_midi_events", config.telemetry_ms)) {
+        std::cerr << "❌ tauwerk_midi start failed" << std::endl;
+        ipc.stop();
+        telemetry.stop();
+        engine.shutdown();
+        return 1;
+    }
+    if (config.autostart) {
+        engine.startClock();
+    }
+
+    const double t_ready = msSince(t_main);
+    char status[128];
+    snprintf(status, sizeof(status), "init %.1f ms, ready %.1f ms", t_init, t_ready);
+    std::cout << "✅ tauwerk_midi ready (" << status << ")" << std::endl;
+    notifySystemd(std::string("READY=1\nSTATUS=") + status);
+
+    // Erster Tick nur mit autostart messen (sonst enthielte die Zeit das Warten
+    // auf Play): bis dahin fein pollen, höchstens FIRST_TICK_WAIT_NS (Slave
+    // ohne externe Clock). Danach nur noch auf Signale warten.
+    constexpr int64_t FIRST_TICK_WAIT_NS = 2'000'000'000;
+    bool first_tick = !config.autostart;
+    while (true) {
+        timespec timeout = first_tick ? timespec{1, 0} : timespec{0, 1'000'000};
+        int sig = sigtimedwait(&signals, nullptr, &timeout);
+        if (sig == SIGINT || sig == SIGTERM) break;
+
+        if (!first_tick && engine.tickCount() > 0) {
+            first_tick = true;
+            snprintf(status, sizeof(status), "init %.1f ms, ready %.1f ms, first tick %.1f ms",
+                     t_init, t_ready, msSince(t_main));
+            std::cout << "⏱ Cold start: " << status << std::endl;
+            notifySystemd(std::string("STATUS=") + status);
+        } else if (!first_tick && monotonicNs() - t_main > FIRST_TICK_WAIT_NS) {
+            first_tick = true;
+            std::cerr << "⚠️  No clock tick within " << FIRST_TICK_WAIT_NS / 1'000'000 << " ms of start" << std::endl;
+        }
+    }
+
+    // 🛑 Erst keine neuen Kommandos mehr, dann Engine leeren und Noten lösen
+    notifySystemd("STOPPING=1");
+    ipc.stop();
+    telemetry.stop();
+    int released = engine.shutdown();
+
+    LockFreeEngine::Stats stats = engine.getStats();
+    std::cout << "🛑 tauwerk_midi stopped: " << released << " notes released, "
+              << stats.midi_messages << " messages in, "
+              << stats.out_queue_overflows << " out overflows" << std::endl;
+    return 0;
+}
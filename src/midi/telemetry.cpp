@@ -0,0 +1,194 @@
+#include "telemetry.hpp"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace {
+
+int64_t monotonicNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+}
+
+constexpr int64_t HEARTBEAT_NS = 1'000'000'000;
+
+void appendf(std::string& out, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+void appendf(std::string& out, const char* format, ...) {
+    char text[256];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (n > 0) out.append(text, std::min<size_t>(n, sizeof(text) - 1));
+}
+
+} // namespace
+
+Telemetry::Telemetry(LockFreeEngine& engine) : engine_(engine) {}
+
+Telemetry::~Telemetry() {
+    stop();
+}
+
+bool Telemetry::start(const char* address, int state_interval_ms) {
+    if (running_.exchange(true)) return false;
+
+    stop_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (stop_fd_ < 0) {
+        std::cerr << "Telemetry Error: eventfd failed" << std::endl;
+        running_ = false;
+        return false;
+    }
+
+    state_interval_ms_ = std::max(EVENT_INTERVAL_MS, state_interval_ms);
+    try {
+        context_ = std::make_unique<zmq::context_t>(1);
+        socket_ = std::make_unique<zmq::socket_t>(*context_, ZMQ_PUB);
+        socket_->set(zmq::sockopt::sndhwm, SEND_HWM);
+        socket_->set(zmq::sockopt::linger, 0);
+        socket_->bind(address);
+    } catch (const zmq::error_t& e) {
+        std::cerr << "Telemetry Error: cannot bind " << address << ": " << e.what() << std::endl;
+        socket_.reset();
+        context_.reset();
+        close(stop_fd_);
+        stop_fd_ = -1;
+        running_ = false;
+        return false;
+    }
+
+    transport_seen_ = engine_.transportSeq();
+    thread_ = std::thread(&Telemetry::run, this);
+    std::cout << "📡 Telemetry publishing on " << address << std::endl;
+    return true;
+}
+
+void Telemetry::stop() {
+    if (!running_.exchange(false)) return;
+
+    uint64_t one = 1;
+    if (write(stop_fd_, &one, sizeof(one)) != sizeof(one)) {
+        std::cerr << "Telemetry Error: stop signal failed" << std::endl;
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    socket_->close();
+    context_->close();
+    close(stop_fd_);
+    stop_fd_ = -1;
+}
+
+// Fester Takt statt Wecken pro Event: Rate-Limit und Batching in einem
+void Telemetry::run() {
+    pollfd stop = {stop_fd_, POLLIN, 0};
+
+    while (running_.load()) {
+        if (poll(&stop, 1, EVENT_INTERVAL_MS) > 0) break;
+
+        int64_t now = monotonicNs();
+        publishEvents(now);
+        if (now - last_state_ns_ >= static_cast<int64_t>(state_interval_ms_) * 1'000'000) {
+            publishState(now, now - last_state_ns_ >= HEARTBEAT_NS);
+        }
+    }
+}
+
+void Telemetry::publishEvents(int64_t now_ns) {
+    buffer_.assign("[");
+    int count = 0;
+    int64_t dropped = 0;
+
+    auto add = [&](auto&& append) {
+        if (count >= MAX_EVENTS) {
+            dropped++;
+            return;
+        }
+        if (count++ > 0) buffer_ += ',';
+        append();
+    };
+
+    // Transport über die API (Start/Stop aus Python oder Learn)
+    uint32_t transport = engine_.transportSeq();
+    if (transport != transport_seen_) {
+        transport_seen_ = transport;
+        add([&] {
+            appendf(buffer_, "{\"type\":\"transport\",\"source\":\"internal\",\"running\":%s,\"time\":%" PRId64 "}",
+                    engine_.clockRunning() ? "true" : "false", now_ns);
+        });
+    }
+
+    // Queue immer ganz leeren, sonst läuft sie im MIDI-In Thread über
+    MidiMessage msg;
+    while (engine_.popInput(msg)) {
+        add([&] {
+            const uint8_t status = msg.status();
+            if (msg.type() == MidiMessage::TYPE_SYSTEM && (status == 0xFA || status == 0xFB || status == 0xFC)) {
+                appendf(buffer_, "{\"type\":\"transport\",\"source\":\"external\",\"running\":%s,\"time\":%" PRId64 "}",
+                        status == 0xFC ? "false" : "true", msg.timestamp);
+            } else if (msg.type() == MidiMessage::TYPE_MIDI2) {
+                appendf(buffer_, "{\"type\":\"midi2\",\"group\":%d,\"status\":%d,\"index\":%d,\"value\":%" PRIu32
+                        ",\"time\":%" PRId64 "}",
+                        msg.group(), status, msg.data1() << 8 | msg.data2(), msg.words[1], msg.timestamp);
+            } else {
+                appendf(buffer_, "{\"type\":\"midi\",\"group\":%d,\"status\":%d,\"data1\":%d,\"data2\":%d,\"time\":%" PRId64 "}",
+                        msg.group(), status, msg.data1(), msg.data2(), msg.timestamp);
+            }
+        });
+    }
+
+    if (dropped > 0) {
+        events_dropped_.fetch_add(dropped);
+    }
+    if (count > 0) {
+        buffer_ += ']';
+        send("events", buffer_);
+    }
+}
+
+void Telemetry::publishState(int64_t now_ns, bool force) {
+    const LockFreeEngine::Stats stats = engine_.getStats();
+    const int64_t tick = engine_.tickCount();
+
+    buffer_.clear();
+    appendf(buffer_, "{\"bpm\":%.3f,\"running\":%s,\"tick\":%" PRId64 ",\"beat\":%.4f,",
+            engine_.getBpm(), engine_.clockRunning() ? "true" : "false", tick, tick / 24.0);
+    appendf(buffer_, "\"stats\":{\"clock_ticks\":%" PRId64 ",\"midi_messages\":%" PRId64
+            ",\"max_latency_ns\":%" PRId64 ",\"out_queue_overflows\":%" PRId64 ",\"in_queue_overflows\":%" PRId64 ",",
+            stats.clock_ticks, stats.midi_messages, stats.max_latency_ns,
+            stats.out_queue_overflows, stats.in_queue_overflows);
+    appendf(buffer_, "\"redundant_controllers\":%" PRId64 ",\"ring_commands\":%" PRId64 ",\"ring_dropped\":%" PRId64
+            ",\"events_dropped\":%" PRId64 "}",
+            stats.redundant_controllers, stats.ring_commands, stats.ring_dropped, events_dropped_.load());
+
+    // Parameter (Index = Param-ID), damit MIDI Learn auf Swing/Fader beim Client ankommt
+    buffer_ += ",\"params\":[";
+    for (int param = 0; param < MAX_PARAMS; param++) {
+        appendf(buffer_, param > 0 ? ",%.4f" : "%.4f", engine_.getParameter(param));
+    }
+    buffer_ += ']';
+
+    // Konflation: unveränderter Zustand wird nur als Heartbeat wiederholt
+    if (!force && buffer_ == last_state_) return;
+    last_state_ = buffer_;
+    last_state_ns_ = now_ns;
+
+    appendf(buffer_, ",\"seq\":%" PRId64 "}", ++state_seq_);
+    send("state", buffer_);
+}
+
+// Nie blockieren: an der HWM verwirft ZMQ PUB den Frame für diesen Subscriber
+void Telemetry::send(const char* topic, const std::string& body) {
+    socket_->send(zmq::buffer(topic, strlen(topic)), zmq::send_flags::sndmore | zmq::send_flags::dontwait);
+    socket_->send(zmq::buffer(body.data(), body.size()), zmq::send_flags::dontwait);
+}
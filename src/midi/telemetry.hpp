@@ -0,0 +1,64 @@
+#ifndef TELEMETRY_HPP
+#define TELEMETRY_HPP
+
+#include "lockfree_engine.hpp"
+#include <zmq.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+// 📡 Telemetrie: Engine -> Clients über ZMQ PUB (ipc:///tmp/tauwerk_midi_events)
+//
+// Zwei Topics, je ein Multipart-Frame [topic, json]:
+//   "state"  - Tempo, Position, Transport, Stats und alle Parameter
+//              ("params", Index = Param-ID). Konflatiert: es wird immer
+//              der aktuelle Stand aus den Atomics gelesen, nie eine Historie.
+//              Höchstens alle state_interval_ms, nur bei Änderung (plus
+//              Heartbeat jede Sekunde).
+//   "events" - MIDI-In und Transport als JSON-Array pro Zyklus. Pro Zyklus
+//              höchstens MAX_EVENTS, der Rest wird gezählt und verworfen.
+//
+// Die RT-Threads sehen davon nichts: sie schreiben nur in die Input-Queue
+// (bounded, Überlauf = in_queue_overflows). Der Publisher-Thread sendet
+// nicht-blockierend, langsame Subscriber verlieren Frames an der HWM statt
+// Druck aufzubauen.
+class Telemetry {
+public:
+    static constexpr int EVENT_INTERVAL_MS = 10;
+    static constexpr int MAX_EVENTS = 64;          // pro Zyklus -> 6400 Events/s
+    static constexpr int SEND_HWM = 64;            // Frames pro Subscriber
+
+    explicit Telemetry(LockFreeEngine& engine);
+    ~Telemetry();
+
+    bool start(const char* address = "ipc:///tmp/tauwerk_midi_events", int state_interval_ms = 50);
+    void stop();
+
+    int64_t eventsDropped() const { return events_dropped_.load(); }
+
+private:
+    void run();
+    void publishEvents(int64_t now_ns);
+    void publishState(int64_t now_ns, bool force);
+    void send(const char* topic, const std::string& body);
+
+    LockFreeEngine& engine_;
+    std::atomic<bool> running_{false};
+    int stop_fd_ = -1;
+    int state_interval_ms_ = 50;
+    std::unique_ptr<zmq::context_t> context_;
+    std::unique_ptr<zmq::socket_t> socket_;
+    std::thread thread_;
+
+    // Gehört dem Publisher-Thread
+    uint32_t transport_seen_ = 0;
+    std::string last_state_;
+    std::string buffer_;
+    int64_t last_state_ns_ = 0;
+    int64_t state_seq_ = 0;
+    std::atomic<int64_t> events_dropped_{0};
+};
+
+#endif
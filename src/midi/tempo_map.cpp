@@ -0,0 +1,89 @@
+#include "tempo_map.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr int64_t END_OF_TIME = std::numeric_limits<int64_t>::max();
+
+double clampBpm(double bpm) {
+    return std::min(300.0, std::max(20.0, bpm));
+}
+
+} // namespace
+
+TempoMap::TempoMap(std::vector<TempoSegment> segments) : segments_(std::move(segments)) {
+    if (segments_.empty()) {
+        segments_.push_back(TempoSegment{0, 120.0, 120.0, 0});
+    }
+    std::stable_sort(segments_.begin(), segments_.end(),
+        [](const TempoSegment& a, const TempoSegment& b) { return a.start_tick < b.start_tick; });
+    
+    FixedNs time = 0;
+    auto append = [this, &time](int64_t start, int64_t end, double bpm, double slope) {
+        if (end <= start) return;
+        Entry e{start, end, time, period(bpm), bpm, slope};
+        entries_.push_back(e);
+        if (end != END_OF_TIME) {
+            time += duration(e, end - start);
+        }
+    };
+    
+    for (size_t i = 0; i < segments_.size(); i++) {
+        const TempoSegment& s = segments_[i];
+        int64_t next = i + 1 < segments_.size() ? segments_[i + 1].start_tick : END_OF_TIME;
+        double start_bpm = clampBpm(s.start_bpm);
+        double end_bpm = clampBpm(s.end_bpm);
+        
+        if (s.ramp_ticks > 0 && end_bpm != start_bpm) {
+            double slope = (end_bpm - start_bpm) / s.ramp_ticks;
+            int64_t ramp_end = std::min(next, s.start_tick + s.ramp_ticks);
+            append(s.start_tick, ramp_end, start_bpm, slope);
+            append(ramp_end, next, start_bpm + slope * (ramp_end - s.start_tick), 0.0);
+        } else {
+            append(s.start_tick, next, end_bpm, 0.0);
+        }
+    }
+}
+
+FixedNs TempoMap::period(double bpm) {
+    // 60e9 ns / (24 * bpm) = 2.5e15 / Mikro-BPM, < 2^52 -> passt mit 64 Nachkommabits
+    int64_t micro_bpm = std::llround(clampBpm(bpm) * 1e6);
+    return (FixedNs(2'500'000'000'000'000) << 64) / micro_bpm;
+}
+
+// Zeit für `ticks` Ticks ab Abschnittsbeginn: dt/dTick = C / bpm(tick)
+FixedNs TempoMap::duration(const Entry& e, int64_t ticks) {
+    if (e.slope == 0.0) {
+        return ticks * e.period;
+    }
+    double ns = NS_PER_MINUTE_PER_TICK / e.slope * std::log1p(e.slope * ticks / e.bpm);
+    return static_cast<FixedNs>(std::ldexp(ns, 64));
+}
+
+const TempoMap::Entry& TempoMap::find(int64_t tick, size_t& cursor) const {
+    if (cursor >= entries_.size() || tick < entries_[cursor].start_tick) {
+        cursor = 0;
+    }
+    while (cursor + 1 < entries_.size() && tick >= entries_[cursor].end_tick) {
+        cursor++;
+    }
+    return entries_[cursor];
+}
+
+FixedNs TempoMap::tickTime(int64_t tick, size_t& cursor) const {
+    const Entry& e = find(tick, cursor);
+    
+    // Vor dem ersten Segment: mit dessen Start-Tempo rückwärts extrapolieren
+    if (tick < e.start_tick) {
+        return e.start_time - (e.start_tick - tick) * e.period;
+    }
+    return e.start_time + duration(e, tick - e.start_tick);
+}
+
+double TempoMap::bpmAt(int64_t tick, size_t& cursor) const {
+    const Entry& e = find(tick, cursor);
+    if (tick < e.start_tick) return e.bpm;
+    return e.bpm + e.slope * (tick - e.start_tick);
+}
@@ -0,0 +1,63 @@
+#ifndef TEMPO_MAP_HPP
+#define TEMPO_MAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Tempo-Segment ab einem Song-Tick (24 PPQN): Rampe über ramp_ticks von
+// start_bpm nach end_bpm (linear in Ticks), danach end_bpm bis zum nächsten Segment.
+struct TempoSegment {
+    int64_t start_tick;
+    double start_bpm;
+    double end_bpm;
+    int64_t ramp_ticks;
+};
+
+// Zeit in 64.64 Festkomma-Nanosekunden
+using FixedNs = __int128;
+
+// ⏱ Tempo-Map (unveränderlich nach dem Bau)
+//
+// Die Segmente werden in eine Tabelle aus konstanten und linearen Abschnitten
+// mit vorberechneter Startzeit übersetzt. tickTime() integriert geschlossen
+// (Rampe: ln) - pro Tick O(1) mit Cursor, ohne Fehler-Akkumulation.
+// Konstante Abschnitte rechnen exakt: Tick-Periode als 64.64 Festkomma aus
+// dem Tempo in Mikro-BPM, Zeit = Start + n * Periode.
+class TempoMap {
+public:
+    static constexpr double NS_PER_MINUTE_PER_TICK = 60e9 / 24.0;
+    
+    explicit TempoMap(std::vector<TempoSegment> segments);
+    
+    // Zeit von Tick 0 bis tick. cursor gehört dem Aufrufer (0 = Anfang)
+    FixedNs tickTime(int64_t tick, size_t& cursor) const;
+    double bpmAt(int64_t tick, size_t& cursor) const;
+    
+    const std::vector<TempoSegment>& segments() const { return segments_; }
+    
+    // Tick-Periode bei konstantem Tempo (auf 1e-6 BPM quantisiert)
+    static FixedNs period(double bpm);
+    // Auf ganze ns runden
+    static int64_t toNs(FixedNs time) {
+        return static_cast<int64_t>((time + (FixedNs(1) << 63)) >> 64);
+    }
+
+private:
+    struct Entry {
+        int64_t start_tick;
+        int64_t end_tick;   // exklusiv
+        FixedNs start_time;
+        FixedNs period;     // Periode bei bpm
+        double bpm;         // BPM am Abschnittsbeginn
+        double slope;       // BPM pro Tick, 0 = konstant
+    };
+    
+    const Entry& find(int64_t tick, size_t& cursor) const;
+    static FixedNs duration(const Entry& e, int64_t ticks);
+    
+    std::vector<Entry> entries_;
+    std::vector<TempoSegment> segments_;
+};
+
+#endif
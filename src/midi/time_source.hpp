@@ -0,0 +1,58 @@
+#ifndef TIME_SOURCE_HPP
+#define TIME_SOURCE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <cerrno>
+
+// ⏱ Injizierbare Zeitquelle für den Clock-Thread (Nanosekunden, monoton)
+class TimeSource {
+public:
+    virtual ~TimeSource() = default;
+    virtual int64_t now() = 0;
+    virtual void sleepUntil(int64_t deadline_ns) = 0;
+};
+
+// Echtzeit: CLOCK_MONOTONIC mit absoluten Deadlines
+class SteadyTimeSource : public TimeSource {
+public:
+    int64_t now() override {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+    }
+    
+    void sleepUntil(int64_t deadline_ns) override {
+        timespec ts;
+        ts.tv_sec = deadline_ns / 1'000'000'000;
+        ts.tv_nsec = deadline_ns % 1'000'000'000;
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+    }
+};
+
+// 🧪 Virtuelle Zeit: sleepUntil springt sofort zur Deadline.
+// Damit läuft der Clock so schnell wie möglich und bleibt reproduzierbar.
+class VirtualTimeSource : public TimeSource {
+public:
+    explicit VirtualTimeSource(int64_t start_ns = 0) : now_(start_ns) {}
+    
+    int64_t now() override {
+        return now_.load(std::memory_order_acquire);
+    }
+    
+    void sleepUntil(int64_t deadline_ns) override {
+        int64_t current = now_.load(std::memory_order_relaxed);
+        while (deadline_ns > current &&
+               !now_.compare_exchange_weak(current, deadline_ns, std::memory_order_acq_rel)) {}
+    }
+    
+    void advance(int64_t delta_ns) {
+        now_.fetch_add(delta_ns, std::memory_order_acq_rel);
+    }
+
+private:
+    std::atomic<int64_t> now_;
+};
+
+#endif
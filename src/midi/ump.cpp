@@ -0,0 +1,134 @@
+#include "ump.hpp"
+
+namespace ump {
+
+namespace {
+
+// MIDI-1.0 Message in derselben Gruppe
+MidiMessage midi1(const MidiMessage& from, uint8_t status, uint8_t data1, uint8_t data2) {
+    MidiMessage msg(status, data1, data2, from.timestamp);
+    msg.words[0] |= static_cast<uint32_t>(from.group()) << 24;
+    return msg;
+}
+
+MidiMessage midi2(const MidiMessage& from, uint8_t status, uint8_t index1, uint8_t index2, uint32_t value) {
+    MidiMessage msg = MidiMessage::midi2(status, index1, index2, value, from.timestamp);
+    msg.words[0] |= static_cast<uint32_t>(from.group()) << 24;
+    return msg;
+}
+
+} // namespace
+
+uint32_t scaleUp(uint32_t value, int src_bits, int dst_bits) {
+    const int scale_bits = dst_bits - src_bits;
+    uint64_t shifted = static_cast<uint64_t>(value) << scale_bits;
+    const uint32_t center = 1u << (src_bits - 1);
+    if (value <= center) {
+        return static_cast<uint32_t>(shifted);
+    }
+
+    // Oberhalb der Mitte: untere Bits wiederholen, damit Maximum auf Maximum fällt
+    const int repeat_bits = src_bits - 1;
+    uint64_t repeat = value & ((1u << repeat_bits) - 1);
+    repeat = scale_bits > repeat_bits ? repeat << (scale_bits - repeat_bits)
+                                      : repeat >> (repeat_bits - scale_bits);
+    while (repeat != 0) {
+        shifted |= repeat;
+        repeat >>= repeat_bits;
+    }
+    return static_cast<uint32_t>(shifted);
+}
+
+int toMidi1(const MidiMessage& msg, MidiMessage* out) {
+    if (msg.type() != MidiMessage::TYPE_MIDI2) {
+        out[0] = msg;
+        return 1;
+    }
+
+    const uint8_t opcode = msg.status() & 0xF0;
+    const uint8_t channel = msg.status() & 0x0F;
+    const uint8_t index1 = msg.data1() & 0x7F;
+    const uint8_t index2 = msg.data2() & 0x7F;
+    const uint32_t value = msg.words[1];
+
+    switch (opcode) {
+        case 0x80:
+            out[0] = midi1(msg, 0x80 | channel, index1, scaleDown(value >> 16, 16, 7));
+            return 1;
+        case 0x90: {
+            // Note On mit Velocity 0 wäre in MIDI 1.0 eine Note Off
+            uint8_t velocity = scaleDown(value >> 16, 16, 7);
+            out[0] = midi1(msg, 0x90 | channel, index1, velocity ? velocity : 1);
+            return 1;
+        }
+        case 0xA0:
+        case 0xB0:
+            out[0] = midi1(msg, opcode | channel, index1, scaleDown(value, 32, 7));
+            return 1;
+        case 0xC0: {
+            // Options-Bit 0: Bank gültig -> Bank Select MSB/LSB vor dem Program Change
+            int count = 0;
+            if (msg.data2() & 0x01) {
+                out[count++] = midi1(msg, 0xB0 | channel, 0, (value >> 8) & 0x7F);
+                out[count++] = midi1(msg, 0xB0 | channel, 32, value & 0x7F);
+            }
+            out[count++] = midi1(msg, 0xC0 | channel, (value >> 24) & 0x7F, 0);
+            return count;
+        }
+        case 0xD0:
+            out[0] = midi1(msg, 0xD0 | channel, scaleDown(value, 32, 7), 0);
+            return 1;
+        case 0xE0: {
+            uint32_t bend = scaleDown(value, 32, 14);
+            out[0] = midi1(msg, 0xE0 | channel, bend & 0x7F, bend >> 7);
+            return 1;
+        }
+        case 0x20:   // RPN: Bank = MSB, Index = LSB
+        case 0x30: { // NRPN
+            uint8_t address_msb = opcode == 0x20 ? 101 : 99;
+            uint32_t data = scaleDown(value, 32, 14);
+            out[0] = midi1(msg, 0xB0 | channel, address_msb, index1);
+            out[1] = midi1(msg, 0xB0 | channel, address_msb - 1, index2);
+            out[2] = midi1(msg, 0xB0 | channel, 6, data >> 7);
+            out[3] = midi1(msg, 0xB0 | channel, 38, data & 0x7F);
+            return 4;
+        }
+        default:
+            // Per-Note Controller/Pitch Bend/Management, relative (N)RPN
+            return 0;
+    }
+}
+
+MidiMessage toMidi2(const MidiMessage& msg) {
+    if (msg.type() != MidiMessage::TYPE_MIDI1) {
+        return msg;
+    }
+
+    const uint8_t opcode = msg.status() & 0xF0;
+    const uint8_t channel = msg.status() & 0x0F;
+    const uint8_t data1 = msg.data1();
+    const uint8_t data2 = msg.data2();
+
+    switch (opcode) {
+        case 0x80:
+            return midi2(msg, 0x80 | channel, data1, 0, scaleUp(data2, 7, 16) << 16);
+        case 0x90:
+            if (data2 == 0) {
+                return midi2(msg, 0x80 | channel, data1, 0, 0);
+            }
+            return midi2(msg, 0x90 | channel, data1, 0, scaleUp(data2, 7, 16) << 16);
+        case 0xA0:
+        case 0xB0:
+            return midi2(msg, opcode | channel, data1, 0, scaleUp(data2, 7, 32));
+        case 0xC0:
+            return midi2(msg, 0xC0 | channel, 0, 0, static_cast<uint32_t>(data1) << 24);
+        case 0xD0:
+            return midi2(msg, 0xD0 | channel, 0, 0, scaleUp(data1, 7, 32));
+        case 0xE0:
+            return midi2(msg, 0xE0 | channel, 0, 0, scaleUp(data2 << 7 | data1, 14, 32));
+        default:
+            return msg;
+    }
+}
+
+} // namespace ump
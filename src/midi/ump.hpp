@@ -0,0 +1,31 @@
+#ifndef UMP_HPP
+#define UMP_HPP
+
+#include "midi_message.hpp"
+#include <cstdint>
+
+// 🎼 Übersetzung MIDI 1.0 <-> MIDI 2.0 (UMP) nach der M2-104 Spezifikation
+//
+// Hochskalieren per Min-Center-Max: scaleDown(scaleUp(x)) == x, der Weg
+// MIDI 1.0 -> 2.0 -> 1.0 ist also verlustfrei. Ausnahme laut Spezifikation:
+// Note On mit Velocity 0 wird zur Note Off.
+namespace ump {
+
+constexpr int MAX_MIDI1_MESSAGES = 4;   // NRPN/RPN -> 4 CCs
+
+uint32_t scaleUp(uint32_t value, int src_bits, int dst_bits);
+
+inline uint32_t scaleDown(uint32_t value, int src_bits, int dst_bits) {
+    return value >> (src_bits - dst_bits);
+}
+
+// TYPE_MIDI2 -> eine oder mehrere TYPE_MIDI1 Messages, alles andere unverändert.
+// 0 = keine MIDI-1.0 Entsprechung (z.B. Per-Note Controller).
+int toMidi1(const MidiMessage& msg, MidiMessage* out);
+
+// TYPE_MIDI1 -> TYPE_MIDI2, alles andere unverändert
+MidiMessage toMidi2(const MidiMessage& msg);
+
+} // namespace ump
+
+#endif
@@ -6,56 +6,208 @@
 #include <unistd.h>
 #include <sys/mman.h>
 #include <sys/ioctl.h>
+#include <sys/epoll.h>
 #include <linux/gpio.h>
+#include <cerrno>
 #include <cstring>
+#include <ctime>
 #include <chrono>
 #include <thread>
 #include <atomic>
 #include <vector>
-#include <unordered_map>
 #include <csignal>
 #include <cstdlib>
+#include <algorithm>
+#include "doorbell.hpp"
+
+// ⚡ Shared-Memory Event-Ring /tauwerk_gpio (Treiber -> Python)
+//
+// Ein Producer (dieser Treiber), Leser überschreibend: der Treiber wartet
+// nie, der älteste Slot wird überschrieben. Sequenzen laufen ab 1, Event n
+// liegt in Slot (n - 1) % capacity. Producer: slot.seq = 0, Payload,
+// slot.seq = n (release), header.seq = n (release). Leser: header.seq
+// (acquire), Slot kopieren, slot.seq vorher und nachher == n prüfen -
+// sonst überholt, neu aufsetzen bei header.seq - capacity + 1.
+// read_seq schreibt der (Haupt-)Leser zurück, nur damit der Treiber
+// überschriebene ungelesene Events in dropped zählen kann.
+namespace gpio_ring {
+
+constexpr uint32_t MAGIC = 0x54415557;
+constexpr uint32_t VERSION = 2;         // v1: int[4] Slots, ms-Timestamps
+constexpr uint32_t CAPACITY = 256;
+
+// Offsets fest (Python liest mit struct): epoch @16, seq @64, dropped @72, read_seq @128
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t slot_size;
+    uint32_t epoch;     // neu pro Treiberstart: Leser erkennen Neustart (seq beginnt wieder bei 0)
+
+    alignas(64) std::atomic<uint64_t> seq;      // Producer: zuletzt veröffentlicht
+    std::atomic<uint64_t> dropped;              // Producer: ungelesen überschrieben
+    alignas(64) std::atomic<uint64_t> read_seq; // Leser: zuletzt gelesen
+};
+
+struct Slot {
+    std::atomic<uint64_t> seq;      // 0 = wird gerade geschrieben
+    int64_t timestamp_ns;           // CLOCK_MONOTONIC
+    int32_t type;
+    int32_t pin;
+    int32_t value;
+    int32_t reserved;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Ring braucht lock-freie 64-bit Atomics");
+static_assert(sizeof(Header) == 192, "Ring Layout");
+static_assert(sizeof(Slot) == 32, "Ring Layout");
+
+constexpr size_t MAP_SIZE = sizeof(Header) + CAPACITY * sizeof(Slot);
+
+} // namespace gpio_ring
+
+// Monotone Zeit in ns - gleiche Uhr wie die Kernel-Timestamps der GPIO-v2 Events
+static int64_t monotonic_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
 
 class TauwerkGPIODriver {
 private:
     // [Alle structs und Variablen gleich wie vorher...]
-    struct GPIOHandle {
-        int fd;
-        struct gpiohandle_request request;
+    // 🔥 Decode-Zustand: klein und ohne Zeiger, damit ein Edge nur eine
+    // Cache-Line anfasst. Namen und Konfiguration liegen in eigenen Vektoren.
+    struct EncoderState {
+        int64_t last_time;      // ns der letzten Raste, CLOCK_MONOTONIC
+        int32_t value;
+        int8_t ab;              // letzter Gray-Code Zustand (A << 1 | B)
+        int8_t rest;            // Zustand in der Raste
+        int8_t steps;           // Viertelschritte seit der letzten Raste
+        int8_t direction;
+        uint8_t pin_a;
+        uint8_t pin_b;
+        uint8_t bit_a;          // Bit in line_bits
+        uint8_t bit_b;
     };
 
-    struct EncoderState {
-        int last_a;
-        int last_b;
-        int value;
-        int direction;
-        std::chrono::steady_clock::time_point last_time;
-        int pin_a;
-        int pin_b;
+    // 👆 Gesten pro Button (0 = aus), per [gpio] in hardware.ini
+    struct Gesture {
+        int long_press_ms = 600;
+        int double_tap_ms = 0;      // an: TAP erst nach Ablauf des Fensters
+        int repeat_delay_ms = 0;    // Halten -> REPEAT ab dieser Zeit
+        int repeat_ms = 150;        // erstes Intervall, wird pro Wiederholung kürzer
+        int repeat_min_ms = 40;
     };
 
     struct ButtonState {
-        int last_state;
-        std::chrono::steady_clock::time_point last_time;
-        int pin;
+        int64_t last_time;      // ns der letzten Meldung
+        uint8_t pin;
+        uint8_t bit;            // Bit in line_bits
+        uint8_t last_state;     // gemeldeter Zustand (1 = gedrückt)
+        uint8_t level;          // letzter Pegel aus dem Edge-Stream (invertiert)
+        bool pending;           // Prellen: nach DEBOUNCE_MS erneut prüfen
+    };
+    
+    // Gesten-Timer, nur bei Zustandswechseln und in button_timers()
+    struct GestureState {
+        int64_t pressed_at;
+        int64_t tap_deadline;   // offener Einzel-Tap (0 = keiner)
+        int64_t next_repeat;
+        int64_t repeat_interval;
+        int32_t repeats;
+        bool long_fired;
+        bool second_tap;
+    };
+
+    // Event-Typen im Ring (Python: GPIOBridge.EVENT_TYPES)
+    enum EventType {
+        EVENT_ENCODER = 0,
+        EVENT_BUTTON = 1,       // roh: 1 = gedrückt, 0 = losgelassen
+        EVENT_TAP = 2,
+        EVENT_DOUBLE_TAP = 3,
+        EVENT_LONG_PRESS = 4,
+        EVENT_REPEAT = 5,       // value = Nummer der Wiederholung
     };
 
+    enum LineKind : uint8_t { LINE_ENCODER, LINE_BUTTON };
+
+    struct LineInfo {
+        uint8_t pin;
+        LineKind kind;
+        uint8_t index;          // in encoders / buttons
+    };
+
+    // Bitmaske line_bits (64 Lines) und Chip-Offsets des Pi passen in 64
+    static constexpr int MAX_LINES = 64;
+    static constexpr int MAX_PINS = 64;
+
     std::atomic<bool> running{true};
-    std::unordered_map<int, GPIOHandle> gpio_handles;
-    std::unordered_map<int, EncoderState> encoders;
-    std::unordered_map<int, ButtonState> buttons;
+    
+    // 🧊 Aus der INI einmal zusammengebaut, danach nur noch gelesen:
+    // dichte Arrays, Index = kleine id, Pin -> Bit vorberechnet. Ein
+    // Poll-/Decode-Durchlauf hasht nicht und berührt nur diese Arrays.
+    std::vector<EncoderState> encoders;
+    std::vector<ButtonState> buttons;
+    std::vector<GestureState> button_gestures;      // parallel zu buttons
+    
+    // ❄️ Kalt: nur beim Einrichten und für Logs
+    std::vector<Gesture> gesture_config;            // parallel zu buttons
+    std::vector<std::string> line_names;            // Index = Bit
+    
+    // ⚡ Alle Lines in einem Request: v2 mit Edge-Events (epoll) oder
+    // v1 Multi-Line Handle zum Pollen. Pegel aller Lines als Bitmaske,
+    // Bit i = lines[i]
+    std::vector<LineInfo> lines;
+    int8_t pin_line[MAX_PINS];                   // Pin (Chip-Offset) -> Bit, -1 = frei
+    uint64_t line_bits = 0;
+    int request_fd = -1;                         // v2 Edge-Request
+    int poll_fd = -1;                            // v1 Handle (Fallback)
+    int epoll_fd = -1;
+    uint64_t polls = 0;
+    uint64_t poll_syscalls = 0;
+    uint32_t last_seqno = 0;
+    uint64_t missed_events = 0;
+    
+    // 🔔 Doorbell für Leser, geklingelt einmal pro Durchlauf (Edge-Batch / Poll-Zyklus)
+    DoorbellServer doorbell{"/tmp/tauwerk_gpio_doorbell"};
+    
     int shm_fd;
-    int* shared_buffer;
-    std::atomic<int> write_index{0};
-    const int BUFFER_SIZE = 256;
+    gpio_ring::Header* ring_header;
+    gpio_ring::Slot* ring_slots;
+    uint64_t ring_seq = 0;
     const int DEBOUNCE_MS = 5;
+    
+    // 🎛️ Encoder, per [gpio] in hardware.ini einstellbar
+    int steps_per_detent = 4;       // Flanken pro Raste (EC11: 4)
+    int accel_max = 8;              // Faktor bei schnellstem Drehen (1 = aus)
+    int accel_slow_ms = 80;         // Rastenabstand ab dem nicht beschleunigt wird
+    int accel_fast_ms = 10;         // ... und ab dem der volle Faktor gilt
+    
+    // Gesten: Vorgabe für alle Buttons, einzeln überschreibbar (a_push.long_press_ms)
+    Gesture gesture_defaults;
+    struct GestureOverride {
+        std::string button;
+        std::string key;
+        int value;
+    };
+    std::vector<GestureOverride> gesture_overrides;
 
 public:
-    TauwerkGPIODriver() : shm_fd(-1), shared_buffer(nullptr) {}
+    TauwerkGPIODriver() : shm_fd(-1), ring_header(nullptr), ring_slots(nullptr) {
+        memset(pin_line, -1, sizeof(pin_line));
+    }
     
     bool initialize() {
         setup_shared_memory();
         
+        // Ein epoll für alles: Edge-Events, Doorbell-Socket und Clients
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd < 0) {
+            std::cerr << "❌ epoll_create1 failed: " << strerror(errno) << std::endl;
+        }
+        setup_doorbell();
+        
         // ✅ JETZT MIT INI KONFIGURATION
         if (!load_ini_config()) {
             std::cout << "❌ Using fallback hardware configuration" << std::endl;
@@ -65,6 +217,11 @@ public:
             setup_button("back", 20);
             setup_button("confirm", 21);
         }
+        
+        // Edge-Events (GPIO v2), sonst v1 Handle + Polling
+        if (!request_edge_lines()) {
+            request_poll_lines();
+        }
 
         std::cout << "☰ Tauwerk GPIO Driver initialized (INI config)" << std::endl;
         return true;
@@ -76,15 +233,20 @@ public:
       if (!config_file.is_open()) return false;
       
       std::string line;
+      std::string section;
       bool found_config = false;
       
       while (std::getline(config_file, line)) {
         // Trim
-        line.erase(0, line.find_first_not_of(" \t"));
-        line.erase(line.find_last_not_of(" \t") + 1);
+        line.erase(0, line.find_first_not_of(" \t\r"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
         
-        // Skip comments/empty/sections
-        if (line.empty() || line[0] == ';' || line[0] == '#' || line[0] == '[') continue;
+        // Skip comments/empty
+        if (line.empty() || line[0] == ';' || line[0] == '#') continue;
+        if (line[0] == '[') {
+          section = line;
+          continue;
+        }
         
         size_t eq_pos = line.find('=');
         if (eq_pos == std::string::npos) continue;
@@ -98,6 +260,26 @@ public:
         val.erase(0, val.find_first_not_of(" \t"));
         val.erase(val.find_last_not_of(" \t") + 1);
         
+        // Treiber-Einstellungen: [gpio]
+        if (section == "[gpio]") {
+          try {
+            if (key == "steps_per_detent") steps_per_detent = std::min(64, std::max(1, std::stoi(val)));   // int8 steps
+            else if (key == "accel_max") accel_max = std::max(1, std::stoi(val));
+            else if (key == "accel_slow_ms") accel_slow_ms = std::stoi(val);
+            else if (key == "accel_fast_ms") accel_fast_ms = std::stoi(val);
+            else if (key.find('.') != std::string::npos) {
+              size_t dot = key.find('.');
+              gesture_overrides.push_back({key.substr(0, dot), key.substr(dot + 1), std::stoi(val)});
+            }
+            else if (!set_gesture(gesture_defaults, key, std::stoi(val))) {
+              std::cerr << "⚠️  Unknown [gpio] key: " << key << std::endl;
+            }
+          } catch (const std::exception&) {
+            std::cerr << "⚠️  Invalid value for [gpio] " << key << ": " << val << std::endl;
+          }
+          continue;
+        }
+        
         // Encoder: controller.encoder.name = pin1,pin2
         size_t encoder_pos = key.find(".encoder.");
         if (encoder_pos != std::string::npos && encoder_pos > 0) {
@@ -128,23 +310,177 @@ public:
         }
       }
       
+      if (accel_fast_ms >= accel_slow_ms) accel_max = 1;
+      apply_gestures();
       return found_config;
     }
     
+    bool set_gesture(Gesture& gesture, const std::string& key, int value) {
+        value = std::max(0, value);
+        if (key == "long_press_ms") gesture.long_press_ms = value;
+        else if (key == "double_tap_ms") gesture.double_tap_ms = value;
+        else if (key == "repeat_delay_ms") gesture.repeat_delay_ms = value;
+        else if (key == "repeat_ms") gesture.repeat_ms = std::max(1, value);
+        else if (key == "repeat_min_ms") gesture.repeat_min_ms = std::max(1, value);
+        else return false;
+        return true;
+    }
+    
+    // Buttons entstehen beim Lesen von [controllers], [gpio] kann danach kommen
+    void apply_gestures() {
+        gesture_config.assign(buttons.size(), gesture_defaults);
+        for (const auto& o : gesture_overrides) {
+            bool found = false;
+            for (size_t i = 0; i < buttons.size(); i++) {
+                if (line_names[buttons[i].bit] != o.button) continue;
+                found = set_gesture(gesture_config[i], o.key, o.value);
+                if (!found) std::cerr << "⚠️  Unknown gesture key: " << o.key << std::endl;
+                found = true;
+            }
+            if (!found) std::cerr << "⚠️  [gpio] " << o.button << "." << o.key << ": no such button" << std::endl;
+        }
+    }
+    
     // [Rest der Methoden UNVERÄNDERT...]
     void setup_encoder(const std::string& name, int pin_a, int pin_b) {
-        setup_gpio_input(name + "_a", pin_a);
-        setup_gpio_input(name + "_b", pin_b);
-        encoders[pin_a] = {0, 0, 0, 0, std::chrono::steady_clock::now(), pin_a, pin_b};
+        if (!line_free(pin_a) || !line_free(pin_b) || pin_a == pin_b || lines.size() + 2 > MAX_LINES) {
+            std::cerr << "❌ Encoder " << name << ": invalid or duplicate pins " << pin_a << ", " << pin_b << std::endl;
+            return;
+        }
+        int index = encoders.size();
+        EncoderState state = {};
+        state.last_time = monotonic_ns();
+        state.pin_a = pin_a;
+        state.pin_b = pin_b;
+        state.bit_a = add_line(name + "_a", pin_a, LINE_ENCODER, index);
+        state.bit_b = add_line(name + "_b", pin_b, LINE_ENCODER, index);
+        encoders.push_back(state);
         std::cout << "╰ Encoder " << name << " pins: " << pin_a << ", " << pin_b << std::endl;
     }
     
     void setup_button(const std::string& name, int pin) {
-        setup_gpio_input(name, pin);
-        buttons[pin] = {0, std::chrono::steady_clock::now(), pin};
+        if (!line_free(pin) || lines.size() + 1 > MAX_LINES) {
+            std::cerr << "❌ Button " << name << ": invalid or duplicate pin " << pin << std::endl;
+            return;
+        }
+        ButtonState state = {};
+        state.last_time = monotonic_ns();
+        state.pin = pin;
+        state.bit = add_line(name, pin, LINE_BUTTON, buttons.size());
+        buttons.push_back(state);
+        button_gestures.push_back({});
+        gesture_config.push_back(gesture_defaults);
         std::cout << "╰ Button " << name << " pin: " << pin << std::endl;
     }
     
+    bool line_free(int pin) const {
+        return pin >= 0 && pin < MAX_PINS && pin_line[pin] < 0;
+    }
+    
+    int add_line(const std::string& name, int pin, LineKind kind, int index) {
+        int bit = lines.size();
+        pin_line[pin] = bit;
+        lines.push_back({static_cast<uint8_t>(pin), kind, static_cast<uint8_t>(index)});
+        line_names.push_back(name);
+        return bit;
+    }
+    
+    bool watch_fd(int fd, uint32_t events) {
+        if (epoll_fd < 0) return false;
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = events;
+        ev.data.fd = fd;
+        return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == 0;
+    }
+    
+    // ⚡ GPIO v2: alle Lines in einem Request, beide Flanken, Kernel-Timestamps
+    // (CLOCK_MONOTONIC). Alte Kernel/Treiber ohne v2 -> false, dann Polling.
+    bool request_edge_lines() {
+#ifdef GPIO_V2_GET_LINE_IOCTL
+        if (lines.empty() || lines.size() > GPIO_V2_LINES_MAX) return false;
+        
+        int chip_fd = open("/dev/gpiochip0", O_RDWR | O_CLOEXEC);
+        if (chip_fd < 0) {
+            std::cerr << "     Failed to open gpiochip0" << std::endl;
+            return false;
+        }
+        
+        struct gpio_v2_line_request req;
+        memset(&req, 0, sizeof(req));
+        for (size_t i = 0; i < lines.size(); i++) {
+            req.offsets[i] = lines[i].pin;
+        }
+        req.num_lines = lines.size();
+        req.config.flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING | GPIO_V2_LINE_FLAG_EDGE_FALLING;
+        req.event_buffer_size = lines.size() * 32;  // Reserve für schnelle Encoder-Bursts
+        strncpy(req.consumer, "tauwerk_gpio", sizeof(req.consumer) - 1);
+        
+        if (ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &req) < 0) {
+            std::cerr << "     GPIO v2 edge request failed (" << strerror(errno) << ") - falling back to polling" << std::endl;
+            close(chip_fd);
+            return false;
+        }
+        close(chip_fd);
+        request_fd = req.fd;
+        
+        if (!watch_fd(request_fd, EPOLLIN)) {
+            std::cerr << "     epoll setup failed - falling back to polling" << std::endl;
+            close(request_fd);
+            request_fd = -1;
+            return false;
+        }
+        
+        // Startzustand, damit der erste Edge richtig dekodiert wird
+        if (read_line_levels()) {
+            for (auto& state : encoders) {
+                state.ab = line_level(state.bit_a) << 1 | line_level(state.bit_b);
+                state.rest = state.ab;
+            }
+            for (auto& state : buttons) {
+                state.level = line_level(state.bit) == 0 ? 1 : 0;
+                state.last_state = state.level;
+            }
+        }
+        
+        std::cout << "     " << lines.size() << " GPIO lines requested (v2 edge events)" << std::endl;
+        return true;
+#else
+        return false;
+#endif
+    }
+    
+    // Aktuelle Pegel aller Lines in einem ioctl -> line_bits
+    // (v2: Start / nach verlorenen Events, v1: jeder Poll-Zyklus)
+    bool read_line_levels() {
+#ifdef GPIO_V2_GET_LINE_IOCTL
+        if (request_fd >= 0) {
+            struct gpio_v2_line_values values;
+            memset(&values, 0, sizeof(values));
+            values.mask = (lines.size() >= 64) ? ~0ULL : ((1ULL << lines.size()) - 1);
+            if (ioctl(request_fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &values) < 0) {
+                return false;
+            }
+            line_bits = values.bits;
+            return true;
+        }
+#endif
+        if (poll_fd < 0) return false;
+        
+        struct gpiohandle_data data;
+        memset(&data, 0, sizeof(data));
+        poll_syscalls++;
+        if (ioctl(poll_fd, GPIOHANDLE_GET_LINE_VALUES_IOCTL, &data) < 0) {
+            return false;
+        }
+        uint64_t bits = 0;
+        for (size_t i = 0; i < lines.size(); i++) {
+            if (data.values[i]) bits |= 1ULL << i;
+        }
+        line_bits = bits;
+        return true;
+    }
+    
     void setup_shared_memory() {
         shm_fd = shm_open("/tauwerk_gpio", O_CREAT | O_RDWR, 0666);
         if (shm_fd < 0) {
@@ -152,158 +488,460 @@ public:
             return;
         }
         
-        size_t total_size = BUFFER_SIZE * 4 * sizeof(int) + 4 * sizeof(int);
-        ftruncate(shm_fd, total_size);
+        if (ftruncate(shm_fd, gpio_ring::MAP_SIZE) < 0) {
+            std::cerr << "❌ Failed to size shared memory" << std::endl;
+            return;
+        }
         
-        shared_buffer = (int*)mmap(nullptr, total_size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
-        if (shared_buffer == MAP_FAILED) {
+        void* mem = mmap(nullptr, gpio_ring::MAP_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+        if (mem == MAP_FAILED) {
             std::cerr << "❌ Failed to mmap shared memory" << std::endl;
             return;
         }
         
-        memset(shared_buffer, 0, total_size);
-        shared_buffer[BUFFER_SIZE * 4 + 2] = 0x54415557;
+        // Magic zuletzt: Leser sehen nie einen halb initialisierten Header
+        memset(mem, 0, gpio_ring::MAP_SIZE);
+        ring_header = static_cast<gpio_ring::Header*>(mem);
+        ring_slots = reinterpret_cast<gpio_ring::Slot*>(static_cast<char*>(mem) + sizeof(gpio_ring::Header));
+        ring_header->version = gpio_ring::VERSION;
+        ring_header->capacity = gpio_ring::CAPACITY;
+        ring_header->slot_size = sizeof(gpio_ring::Slot);
+        ring_header->epoch = static_cast<uint32_t>(monotonic_ns() ^ getpid()) | 1;
+        std::atomic_thread_fence(std::memory_order_release);
+        ring_header->magic = gpio_ring::MAGIC;
         
-        std::cout << "☰ Shared Memory initialized (" << total_size << " bytes)" << std::endl;
+        std::cout << "☰ Shared Memory initialized (" << gpio_ring::MAP_SIZE << " bytes, ring v" << gpio_ring::VERSION << ")" << std::endl;
     }
     
-    // [setup_gpio_input, read_gpio, write_event, poll_encoders, poll_buttons, run, stop... alles gleich]
-    void setup_gpio_input(const std::string& name, int pin) {
+    // v1 Fallback: ein Handle für alle Lines statt ein fd pro Pin,
+    // gelesen wird mit einem ioctl pro Zyklus
+    void request_poll_lines() {
+        if (lines.empty()) return;
+        if (lines.size() > GPIOHANDLES_MAX) {
+            std::cerr << "     Too many GPIO lines (" << lines.size() << ", max " << GPIOHANDLES_MAX << ")" << std::endl;
+            return;
+        }
+        
         struct gpiohandle_request req;
         memset(&req, 0, sizeof(req));
-        
-        req.lineoffsets[0] = pin;
-        req.lines = 1;
+        for (size_t i = 0; i < lines.size(); i++) {
+            req.lineoffsets[i] = lines[i].pin;
+        }
+        req.lines = lines.size();
         req.flags = GPIOHANDLE_REQUEST_INPUT;
-        strcpy(req.consumer_label, name.c_str());
+        strncpy(req.consumer_label, "tauwerk_gpio", sizeof(req.consumer_label) - 1);
         
-        int chip_fd = open("/dev/gpiochip0", O_RDWR);
+        int chip_fd = open("/dev/gpiochip0", O_RDWR | O_CLOEXEC);
         if (chip_fd < 0) {
-            std::cerr << "     Failed to open gpiochip0 for pin " << pin << std::endl;
+            std::cerr << "     Failed to open gpiochip0" << std::endl;
             return;
         }
         
         if (ioctl(chip_fd, GPIO_GET_LINEHANDLE_IOCTL, &req) < 0) {
-            std::cerr << "     Failed to setup GPIO pin " << pin << std::endl;
+            std::cerr << "     Failed to setup GPIO lines (" << strerror(errno) << ")" << std::endl;
             close(chip_fd);
             return;
         }
         
         close(chip_fd);
-        gpio_handles[pin] = {req.fd, req};
-        std::cout << "     GPIO pin " << pin << " (" << name << ") configured" << std::endl;
+        poll_fd = req.fd;
+        for (size_t i = 0; i < lines.size(); i++) {
+            std::cout << "     GPIO pin " << int(lines[i].pin) << " (" << line_names[i] << ") configured" << std::endl;
+        }
+        
+        // Vorher: ein ioctl pro Encoder-Pin und Button in jedem Zyklus
+        std::cout << "     Syscalls per poll: 1 (was " << (encoders.size() * 2 + buttons.size()) << ")" << std::endl;
+        
+        // Startzustand wie im Edge-Modus, kein Phantom-Event im ersten Zyklus
+        if (read_line_levels()) {
+            for (auto& state : encoders) {
+                state.ab = line_level(state.bit_a) << 1 | line_level(state.bit_b);
+                state.rest = state.ab;
+            }
+            for (auto& state : buttons) {
+                state.last_state = line_level(state.bit) == 0 ? 1 : 0;
+            }
+        }
     }
     
-    int read_gpio(int pin) {
-        auto it = gpio_handles.find(pin);
-        if (it == gpio_handles.end()) return -1;
+    // Pegel aus dem letzten Snapshot (read_line_levels / Edge-Stream), kein Syscall
+    int line_level(int bit) const {
+        return (line_bits >> bit) & 1;
+    }
+    
+    void write_event(int type, int pin, int value, int64_t ts_ns) {
+        if (!ring_header) return;
         
-        struct gpiohandle_data data;
-        memset(&data, 0, sizeof(data));
+        uint64_t seq = ++ring_seq;
+        if (seq - ring_header->read_seq.load(std::memory_order_relaxed) > gpio_ring::CAPACITY) {
+            ring_header->dropped.fetch_add(1, std::memory_order_relaxed);
+        }
         
-        if (ioctl(it->second.fd, GPIOHANDLE_GET_LINE_VALUES_IOCTL, &data) < 0) {
-            return -1;
+        // Slot wie ein Seqlock: erst ungültig, dann Payload, dann Sequenz
+        gpio_ring::Slot& slot = ring_slots[(seq - 1) % gpio_ring::CAPACITY];
+        slot.seq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.timestamp_ns = ts_ns;
+        slot.type = type;
+        slot.pin = pin;
+        slot.value = value;
+        slot.seq.store(seq, std::memory_order_release);
+        ring_header->seq.store(seq, std::memory_order_release);
+        doorbell.notify();
+
+        static const char* TYPE_NAMES[] = {"ENCODER", "BUTTON", "TAP", "DOUBLE_TAP", "LONG_PRESS", "REPEAT"};
+        const char* type_str = (type >= 0 && type <= EVENT_REPEAT) ? TYPE_NAMES[type] : "?";
+        std::cout << "╰ " << type_str << " (" << pin 
+                  << ") " << value << " | SEQ " << seq << std::endl;
+    }
+    
+    void setup_doorbell() {
+        if (epoll_fd < 0) return;
+        doorbell.open([this](int fd) { return watch_fd(fd, EPOLLIN); });
+    }
+    
+    // Socket-Seite des epoll (alles außer den GPIO-Events)
+    void handle_doorbell_fd(int fd) {
+        if (fd == doorbell.fd()) {
+            doorbell.accept([this](int sock) { return watch_fd(sock, EPOLLIN | EPOLLRDHUP); });
+        } else {
+            doorbell.handle_client(fd);
+        }
+    }
+    
+    // Gray-Code Übergangstabelle, Index = alter Zustand << 2 | neuer Zustand.
+    // Gültige Nachbarn +1/-1, keine Änderung oder Sprung über zwei Bits 0:
+    // Prellen auf einer Leitung hebt sich selbst auf (+1 -1).
+    // Vorwärts (A vor B): 00 -> 10 -> 11 -> 01 -> 00
+    static constexpr int8_t QUADRATURE[16] = {
+         0, -1, +1,  0,
+        +1,  0,  0, -1,
+        -1,  0,  0, +1,
+         0, +1, -1,  0,
+    };
+    
+    // Gemeinsam für Polling und Edge-Stream; ts_ns = Zeitpunkt der Flanke
+    void update_encoder(EncoderState& state, int a_val, int b_val, int64_t ts_ns) {
+        int ab = a_val << 1 | b_val;
+        int step = QUADRATURE[state.ab << 2 | ab];
+        state.ab = ab;
+        if (step == 0) return;
+        
+        state.steps += step;
+        if (state.steps < steps_per_detent && state.steps > -steps_per_detent) {
+            // Zurück in der Raste ohne vollen Zyklus (Anstoßen, verlorene
+            // Flanke): neu ausrichten statt Viertelschritte mitzuschleppen
+            if (steps_per_detent == 4 && ab == state.rest) state.steps = 0;
+            return;
         }
         
-        return data.values[0];
+        int direction = (state.steps > 0) ? 1 : -1;
+        state.steps = 0;
+        state.rest = ab;
+        
+        int delta = direction * acceleration(state, direction, ts_ns);
+        state.value += delta;
+        state.direction = direction;
+        state.last_time = ts_ns;
+        write_event(EVENT_ENCODER, state.pin_a, delta, ts_ns);
     }
     
-    void write_event(int type, int pin, int value) {
-        int index = write_index.load();
-        int buffer_offset = index * 4;
+    // Faktor aus dem Abstand zur letzten Raste: langsam = 1, schnell bis
+    // accel_max, linear dazwischen. Richtungswechsel startet wieder bei 1.
+    int acceleration(const EncoderState& state, int direction, int64_t ts_ns) {
+        if (accel_max <= 1 || direction != state.direction) return 1;
         
-        shared_buffer[buffer_offset] = type;
-        shared_buffer[buffer_offset + 1] = pin;
-        shared_buffer[buffer_offset + 2] = value;
-        shared_buffer[buffer_offset + 3] = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::steady_clock::now().time_since_epoch()).count();
-
-        const char* type_str = (type == 0) ? "ENCODER" : "BUTTON";
-        std::cout << "╰ " << type_str << " (" << pin 
-                  << ") " << value << " | MEM " << index << std::endl;
+        int64_t dt_ms = (ts_ns - state.last_time) / 1000000;
+        if (dt_ms >= accel_slow_ms) return 1;
+        if (dt_ms <= accel_fast_ms) return accel_max;
         
-        int new_index = (index + 1) % BUFFER_SIZE;
-        write_index.store(new_index);
-        shared_buffer[BUFFER_SIZE * 4] = new_index;
+        int64_t range = accel_slow_ms - accel_fast_ms;
+        return 1 + static_cast<int>(((accel_max - 1) * (accel_slow_ms - dt_ms) + range / 2) / range);
+    }
+    
+    // Ein Snapshot pro Zyklus, dann Encoder und Buttons daraus dekodieren
+    void poll_lines() {
+        polls++;
+        if (!read_line_levels()) return;
+        poll_encoders();
+        poll_buttons();
     }
     
     void poll_encoders() {
-        for (auto& pair : encoders) {
-            auto& state = pair.second;
-            int a_val = read_gpio(state.pin_a);
-            int b_val = read_gpio(state.pin_b);
-            
-            auto now = std::chrono::steady_clock::now();
-            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - state.last_time).count();
-
-            if (a_val != state.last_a) {
-                if ((a_val == 1) && (b_val != 1)) {
-                    if((state.direction == -1) && elapsed < 20) continue;
-                    state.value += 1;
-                    state.direction = 1;
-                    state.last_time = now;
-                    write_event(0, state.pin_a, 1);
-                }
-            }
-            if (b_val != state.last_b) {
-                if ((b_val == 1) && (a_val != 1)) {
-                    if((state.direction == 1) && elapsed < 20) continue;
-                    state.value -= 1;
-                    state.direction = -1;
-                    state.last_time = now;
-                    write_event(0, state.pin_a, -1);
-                }
-            }
-            
-            state.last_a = a_val;
-            state.last_b = b_val;
+        int64_t now = monotonic_ns();
+        for (auto& state : encoders) {
+            update_encoder(state, line_level(state.bit_a), line_level(state.bit_b), now);
         }
     }
     
     void poll_buttons() {
-        for (auto& pair : buttons) {
-            auto& state = pair.second;
-            int current_state = read_gpio(state.pin);
-            if (current_state < 0) continue;
+        for (size_t i = 0; i < buttons.size(); i++) {
+            const ButtonState& state = buttons[i];
+            int current_state = line_level(state.bit);
 
-            auto now = std::chrono::steady_clock::now();
-            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - state.last_time).count();
-
-            if (elapsed < DEBOUNCE_MS) continue;
+            int64_t now = monotonic_ns();
+            if (now - state.last_time < DEBOUNCE_MS * 1000000LL) continue;
 
             int inverted_state = (current_state == 0) ? 1 : 0;
 
             if (state.last_state != inverted_state) {
-                write_event(1, state.pin, inverted_state);
-                state.last_state = inverted_state;
-                state.last_time = now;
+                report_button(i, inverted_state, now);
+            }
+        }
+        button_timers(monotonic_ns());
+    }
+    
+    // Edge-Stream: erste Flanke sofort melden, danach DEBOUNCE_MS ruhen lassen
+    // und den dann gültigen Pegel nachreichen (sonst geht ein kurzes Loslassen
+    // im Prellen verloren)
+    void button_edge(int index, int level, int64_t ts_ns) {
+        ButtonState& state = buttons[index];
+        state.level = (level == 0) ? 1 : 0;
+        if (ts_ns - state.last_time < DEBOUNCE_MS * 1000000LL) {
+            state.pending = true;
+            return;
+        }
+        if (state.level != state.last_state) {
+            report_button(index, state.level, ts_ns);
+        }
+    }
+    
+    // Entprellter Zustandswechsel: rohes Event sofort, Gesten daraus ableiten
+    void report_button(int index, int pressed, int64_t ts_ns) {
+        ButtonState& button = buttons[index];
+        write_event(EVENT_BUTTON, button.pin, pressed, ts_ns);
+        button.last_state = pressed;
+        button.last_time = ts_ns;
+        
+        GestureState& state = button_gestures[index];
+        const Gesture& g = gesture_config[index];
+        if (pressed) {
+            state.pressed_at = ts_ns;
+            state.long_fired = false;
+            state.repeats = 0;
+            state.repeat_interval = g.repeat_ms * 1000000LL;
+            state.next_repeat = g.repeat_delay_ms > 0 ? ts_ns + g.repeat_delay_ms * 1000000LL : 0;
+            // Zweiter Druck im Fenster: Doppel-Tap, sobald er wieder losgelassen wird
+            state.second_tap = state.tap_deadline != 0 && ts_ns <= state.tap_deadline;
+            state.tap_deadline = 0;
+            return;
+        }
+        
+        state.next_repeat = 0;
+        // Langer Druck / Wiederholung verbrauchen den Tap
+        if (state.long_fired || state.repeats > 0) {
+            state.second_tap = false;
+            return;
+        }
+        if (g.double_tap_ms == 0) {
+            write_event(EVENT_TAP, button.pin, 1, ts_ns);
+        } else if (state.second_tap) {
+            state.second_tap = false;
+            write_event(EVENT_DOUBLE_TAP, button.pin, 2, ts_ns);
+        } else {
+            state.tap_deadline = ts_ns + g.double_tap_ms * 1000000LL;
+        }
+    }
+    
+    // Fällige Entprell- und Gesten-Zeitpunkte abarbeiten. Events tragen den
+    // geplanten Zeitpunkt (ab Kernel-Timestamp des Drucks), nicht den des
+    // Aufwachens. Rückgabe: ms bis zum nächsten Termin (-1 = keiner)
+    int button_timers(int64_t now) {
+        int64_t next = -1;
+        auto schedule = [&](int64_t due) {
+            if (next < 0 || due < next) next = due;
+        };
+        
+        for (size_t i = 0; i < buttons.size(); i++) {
+            ButtonState& button = buttons[i];
+            if (button.pending) {
+                int64_t due = button.last_time + DEBOUNCE_MS * 1000000LL;
+                if (due <= now) {
+                    button.pending = false;
+                    if (button.level != button.last_state) {
+                        report_button(i, button.level, due);
+                    }
+                } else {
+                    schedule(due);
+                }
+            }
+            
+            GestureState& state = button_gestures[i];
+            const Gesture& g = gesture_config[i];
+            if (button.last_state) {
+                if (g.long_press_ms > 0 && !state.long_fired) {
+                    int64_t due = state.pressed_at + g.long_press_ms * 1000000LL;
+                    if (due <= now) {
+                        state.long_fired = true;
+                        write_event(EVENT_LONG_PRESS, button.pin, 1, due);
+                    } else {
+                        schedule(due);
+                    }
+                }
+                // Hold-Repeat, Intervall schrumpft pro Wiederholung um 1/5
+                while (state.next_repeat != 0 && state.next_repeat <= now) {
+                    write_event(EVENT_REPEAT, button.pin, ++state.repeats, state.next_repeat);
+                    state.repeat_interval = std::max<int64_t>(g.repeat_min_ms * 1000000LL, state.repeat_interval * 4 / 5);
+                    state.next_repeat += state.repeat_interval;
+                }
+                if (state.next_repeat != 0) schedule(state.next_repeat);
+            } else if (state.tap_deadline != 0) {
+                if (state.tap_deadline <= now) {
+                    write_event(EVENT_TAP, button.pin, 1, state.tap_deadline);
+                    state.tap_deadline = 0;
+                } else {
+                    schedule(state.tap_deadline);
+                }
             }
         }
+        if (next < 0) return -1;
+        return static_cast<int>((next - now + 999999) / 1000000);
     }
     
+    void handle_edge(int pin, int level, int64_t ts_ns) {
+        if (pin < 0 || pin >= MAX_PINS || pin_line[pin] < 0) return;
+        int bit = pin_line[pin];
+        if (level) {
+            line_bits |= 1ULL << bit;
+        } else {
+            line_bits &= ~(1ULL << bit);
+        }
+        
+        const LineInfo& line = lines[bit];
+        if (line.kind == LINE_ENCODER) {
+            auto& state = encoders[line.index];
+            update_encoder(state, line_level(state.bit_a), line_level(state.bit_b), ts_ns);
+        } else {
+            button_edge(line.index, level, ts_ns);
+        }
+    }
+    
+#ifdef GPIO_V2_GET_LINE_IOCTL
+    // ⚡ Blockiert in epoll bis Flanken anliegen - im Leerlauf keine CPU-Last.
+    // Zeitstempel kommen vom Kernel (IRQ-Zeitpunkt), nicht vom Aufwachen.
+    void run_events() {
+        struct epoll_event ready[8];
+        
+        while (running) {
+            // Gesten-Timer können Events erzeugt haben: vor dem Schlafen klingeln
+            int timeout = button_timers(monotonic_ns());
+            doorbell.ring();
+            
+            int n = epoll_wait(epoll_fd, ready, 8, timeout);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                std::cerr << "❌ epoll_wait failed: " << strerror(errno) << std::endl;
+                break;
+            }
+            
+            for (int i = 0; i < n; i++) {
+                if (ready[i].data.fd != request_fd) {
+                    handle_doorbell_fd(ready[i].data.fd);
+                } else if (!read_edges()) {
+                    return;
+                }
+            }
+        }
+    }
+    
+    // Ein Batch Edge-Events vom Kernel. false = Request-fd kaputt
+    bool read_edges() {
+        struct gpio_v2_line_event events[64];
+        
+        ssize_t bytes = read(request_fd, events, sizeof(events));
+        if (bytes < 0) {
+            if (errno == EINTR || errno == EAGAIN) return true;
+            std::cerr << "❌ GPIO event read failed: " << strerror(errno) << std::endl;
+            return false;
+        }
+        
+        size_t count = bytes / sizeof(events[0]);
+        for (size_t i = 0; i < count; i++) {
+            const auto& event = events[i];
+            
+            // Lücke in der Sequenz = Kernel-Puffer übergelaufen: Pegel neu lesen
+            if (last_seqno != 0 && event.seqno != last_seqno + 1) {
+                missed_events += event.seqno - last_seqno - 1;
+                std::cerr << "⚠️  " << (event.seqno - last_seqno - 1) << " GPIO edges lost" << std::endl;
+                read_line_levels();
+            }
+            last_seqno = event.seqno;
+            
+            int level = (event.id == GPIO_V2_LINE_EVENT_RISING_EDGE) ? 1 : 0;
+            handle_edge(event.offset, level, static_cast<int64_t>(event.timestamp_ns));
+        }
+        
+        return true;
+    }
+#endif
+    
     void run() {
         std::cout << "▶ Tauwerk GPIO Driver started..." << std::endl;
+        
+#ifdef GPIO_V2_GET_LINE_IOCTL
+        if (request_fd >= 0) {
+            std::cout << "☰ Edge events (GPIO v2, epoll) - Waiting for hardware events..." << std::endl;
+            run_events();
+            return;
+        }
+#endif
         std::cout << "☰ Polling at 1kHz - Waiting for hardware events..." << std::endl;
         
+        // Statt sleep: 1 ms in epoll, dabei Doorbell-Clients bedienen
+        struct epoll_event ready[8];
         while (running) {
-            poll_encoders();
-            poll_buttons();
-            std::this_thread::sleep_for(std::chrono::microseconds(1000));
+            poll_lines();
+            doorbell.ring();
+            
+            if (epoll_fd < 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(1000));
+                continue;
+            }
+            int n = epoll_wait(epoll_fd, ready, 8, 1);
+            for (int i = 0; i < n; i++) {
+                handle_doorbell_fd(ready[i].data.fd);
+            }
         }
     }
     
     void stop() {
         running = false;
         
-        for (auto& handle : gpio_handles) {
-            close(handle.second.fd);
+        if (poll_fd >= 0) {
+            close(poll_fd);
+            poll_fd = -1;
+            if (polls > 0) {
+                std::cout << "☰ " << polls << " polls, " << (double)poll_syscalls / polls << " syscalls/poll" << std::endl;
+            }
+        }
+        if (request_fd >= 0) {
+            close(request_fd);
+            request_fd = -1;
+        }
+        if (doorbell.fd() >= 0) {
+            std::cout << "🔔 " << doorbell.rings() << " doorbell rings for " << ring_seq << " events" << std::endl;
+            doorbell.close();
+        }
+        if (epoll_fd >= 0) {
+            close(epoll_fd);
+            epoll_fd = -1;
+        }
+        if (missed_events > 0) {
+            std::cout << "⚠️  " << missed_events << " GPIO edges lost in total" << std::endl;
         }
         
-        if (shared_buffer) {
-            munmap(shared_buffer, 4096);
+        if (ring_header) {
+            uint64_t dropped = ring_header->dropped.load();
+            if (dropped > 0) {
+                std::cout << "⚠️  " << dropped << " GPIO events overwritten before read" << std::endl;
+            }
+            munmap(ring_header, gpio_ring::MAP_SIZE);
+            ring_header = nullptr;
+            ring_slots = nullptr;
         }
         if (shm_fd >= 0) {
             close(shm_fd);
+            shm_fd = -1;
             shm_unlink("/tauwerk_gpio");
         }
         
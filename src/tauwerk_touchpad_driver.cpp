@@ -15,6 +15,7 @@
 #include <algorithm>
 #include <array>
 #include <set>
+#include "doorbell.hpp"
 
 // DRM/KMS Headers
 #include <xf86drm.h>
@@ -461,6 +462,10 @@ private:
     int command_shm_fd;
     int event_shm_fd;
 
+    // Doorbell: klingelt einmal pro Durchlauf, wenn neue UI-Events im Ring liegen
+    DoorbellServer doorbell{"/tmp/tauwerk_ui_doorbell"};
+    uint64_t ui_events = 0;
+
     int fps_limit;
     int frame_count;
     std::chrono::steady_clock::time_point last_fps_check;
@@ -489,6 +494,7 @@ public:
             std::cerr << "❌ Shared memory setup failed" << std::endl;
             return false;
         }
+        doorbell.open();    // optional - ohne Doorbell pollt Python weiter
 
         std::cout << "✅ Tauwerk Touch UI (DRM) initialized" << std::endl;
         return true;
@@ -596,6 +602,8 @@ public:
         
         int* control = (int*)(event_buffer + BUFFER_SIZE);
         control[0] = new_index;
+        doorbell.notify();
+        ui_events++;
     }
 
     // ═══════════════════════════════════════════════════════════════════
@@ -988,7 +996,9 @@ public:
         while (running) {
             auto frame_start = std::chrono::steady_clock::now();
             
+            doorbell.service();     // Loop schläft ohnehin 10 ms: kein eigenes poll nötig
             process_touch_events();
+            doorbell.ring();
             process_python_commands();
             update_fader_animations();
             
@@ -1022,6 +1032,10 @@ public:
             close(event_shm_fd);
             shm_unlink("/tauwerk_ui_events");
         }
+        if (doorbell.fd() >= 0) {
+            std::cout << "🔔 " << doorbell.rings() << " doorbell rings for " << ui_events << " events" << std::endl;
+            doorbell.close();
+        }
         
         std::cout << "■ Tauwerk Touch UI stopped" << std::endl;
     }